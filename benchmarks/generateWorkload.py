@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+
+"""
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+"""
+
+# Generates synthetic MPI translation units to measure how the checks
+# scale. Rank cases come in pairs: an even case sends to rank + 1, the
+# following odd case receives from rank - 1 with the same tags, so the
+# point to point schema is fulfilled and a correct checker reports
+# nothing. Requests are posted by nonblocking receives in a function
+# next to each rank case function and completed by MPI_Waitall.
+#
+# usage: generateWorkload.py [--rank-cases N] [--calls-per-case N]
+#                            [--depth N] [--requests N] [--functions N]
+#                            [--request-loop] [-o FILE]
+
+import argparse
+import sys
+
+INDENT = '    '
+
+
+def rank_case_body(case, calls, depth):
+    """Returns the lines of a rank case, nested in depth blocks."""
+    lines = []
+    for call in range(calls):
+        tag = case // 2 * calls + call
+        if case % 2 == 0:
+            lines.append('MPI_Send(&buf[%d], 1, MPI_DOUBLE, rank + 1, %d, '
+                         'MPI_COMM_WORLD);' % (call, tag))
+        else:
+            lines.append('MPI_Recv(&buf[%d], 1, MPI_DOUBLE, rank - 1, %d, '
+                         'MPI_COMM_WORLD, MPI_STATUS_IGNORE);' % (call, tag))
+
+    # blocks do not change the schema, they only deepen the ast
+    for level in reversed(range(depth)):
+        lines = (['if (size > %d) {' % level] +
+                 [INDENT + line for line in lines] + ['}'])
+    return lines
+
+
+def rank_case_function(index, args):
+    """Returns a function containing all rank cases."""
+    lines = ['void exchange%d() {' % index,
+             INDENT + 'int rank = 0;',
+             INDENT + 'int size = 0;',
+             INDENT + 'double buf[%d];' % max(args.calls_per_case, 1),
+             INDENT + 'MPI_Comm_rank(MPI_COMM_WORLD, &rank);',
+             INDENT + 'MPI_Comm_size(MPI_COMM_WORLD, &size);']
+    for case in range(args.rank_cases):
+        keyword = 'if' if case == 0 else '} else if'
+        lines.append(INDENT + '%s (rank == %d) {' % (keyword, case))
+        lines += [INDENT * 2 + line for line in
+                  rank_case_body(case, args.calls_per_case, args.depth)]
+    if args.rank_cases:
+        lines.append(INDENT + '}')
+    lines.append('}')
+    return lines
+
+
+def request_function(index, args):
+    """Returns a function posting and completing nonblocking requests."""
+    count = args.requests
+    lines = ['void post%d() {' % index,
+             INDENT + 'double buf[%d];' % count,
+             INDENT + 'MPI_Request requests[%d];' % count]
+    post = ('MPI_Irecv(&buf[%s], 1, MPI_DOUBLE, %s, 0, MPI_COMM_WORLD, '
+            '&requests[%s]);')
+    if args.request_loop:
+        lines.append(INDENT + 'for (int i = 0; i < %d; ++i) {' % count)
+        lines.append(INDENT * 2 + post % ('i', 'i', 'i'))
+        lines.append(INDENT + '}')
+    else:
+        lines += [INDENT + post % (i, i, i) for i in range(count)]
+    lines.append(INDENT + 'MPI_Waitall(%d, requests, MPI_STATUSES_IGNORE);'
+                 % count)
+    lines.append('}')
+    return lines
+
+
+def generate(args):
+    """Returns the source of a translation unit."""
+    lines = ['// generated by generateWorkload.py: rank cases %d, calls per '
+             'case %d,' % (args.rank_cases, args.calls_per_case),
+             '// depth %d, requests %d%s, functions %d' %
+             (args.depth, args.requests,
+              ' in a loop' if args.request_loop else '', args.functions),
+             '', '#include <mpi.h>', '']
+    for index in range(args.functions):
+        lines += rank_case_function(index, args) + ['']
+        if args.requests:
+            lines += request_function(index, args) + ['']
+    return '\n'.join(lines)
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(
+        description='Generate a synthetic MPI translation unit.')
+    parser.add_argument('--rank-cases', type=int, default=2,
+                        help='rank cases per function, rounded to pairs')
+    parser.add_argument('--calls-per-case', type=int, default=1,
+                        help='point to point calls per rank case')
+    parser.add_argument('--depth', type=int, default=0,
+                        help='blocks each rank case body is nested in')
+    parser.add_argument('--requests', type=int, default=0,
+                        help='nonblocking requests posted per function')
+    parser.add_argument('--functions', type=int, default=1,
+                        help='functions per translation unit')
+    parser.add_argument('--request-loop', action='store_true',
+                        help='post requests in a loop instead of unrolled')
+    parser.add_argument('-o', '--output', default='-',
+                        help='output file (default: stdout)')
+    args = parser.parse_args(argv)
+    # an unpaired last case would have no partner
+    args.rank_cases -= args.rank_cases % 2
+    return args
+
+
+def main():
+    args = parse_args()
+    source = generate(args)
+    if args.output == '-':
+        sys.stdout.write(source)
+    else:
+        with open(args.output, 'w') as output:
+            output.write(source)
+
+
+if __name__ == '__main__':
+    main()
@@ -50,6 +50,22 @@ function analyze() {
 }
 alias checkMPI='analyze -enable-checker lx.MPIChecker'
 
+# incremental ast checks, unchanged translation units are replayed from cache
+function checkMPIIncremental() {
+    if [[ ! -d build/mpi-check ]]; then
+        mkdir -p build/mpi-check
+    fi
+    cd build/mpi-check
+    cmake ../../ \
+        -G Ninja \
+        -DCMAKE_BUILD_TYPE=DEBUG \
+        -DCMAKE_EXPORT_COMPILE_COMMANDS=ON
+
+    mpi-check -p . --cache-dir=mpi-check-cache $@
+
+    cd ../../
+}
+
 # debug
 function cmd() {
     if [[ ! -d build/debug ]]; then
@@ -69,12 +69,21 @@ if [[ $? -eq 0 ]]; then
     $sed -i "${lineNo}i \ \ \${MPI-CHECKER}" CMakeLists.txt
 
 
-    # symlink test source
+    # symlink test sources
     abspath() {
         [[ $1 = /* ]] && echo "$1" || echo "$PWD/${1#./}"
     }
     ln -s `abspath MPI-Checker/tests/MPICheckerTest.c` \
         `abspath ../../../test/Analysis/MPICheckerTest.c`
+    ln -s `abspath MPI-Checker/tests/perf` \
+        `abspath ../../../test/Analysis/MPICheckerPerf`
+    ln -s `abspath MPI-Checker/tests/summary` \
+        `abspath ../../../test/Analysis/MPICheckerSummary`
+
+    # symlink and register mpi-check driver
+    ln -s `abspath MPI-Checker/tools/mpi-check` \
+        `abspath ../../../tools/mpi-check`
+    echo "add_subdirectory(mpi-check)" >> ../../../tools/CMakeLists.txt
 
     cd ../../../../../../
 
@@ -0,0 +1,76 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#include "CanonicalForm.hpp"
+#include "Container.hpp"
+#include "llvm/ADT/SmallVector.h"
+#include <memory>
+
+namespace mpi {
+
+void CanonicalForm::Profile(llvm::FoldingSetNodeID &id,
+                            llvm::ArrayRef<StatementComponent> components,
+                            const bool isOrdered) {
+    id.AddBoolean(isOrdered);
+    for (const StatementComponent &component : components) {
+        id.AddInteger(static_cast<unsigned>(component.type_));
+        id.AddPointer(component.identity_);
+        id.AddInteger(component.value_);
+    }
+}
+
+/**
+ * Returns the unique canonical form for a component sequence.
+ *
+ * @param components in statement order
+ * @param isOrdered if false components are compared as permutation
+ *
+ * @return canonical form
+ */
+const CanonicalForm *CanonicalFormTable::get(
+    llvm::ArrayRef<StatementComponent> components, const bool isOrdered) {
+    llvm::SmallVector<StatementComponent, 8> sortedComponents;
+    if (!isOrdered) {
+        cont::copy(components, sortedComponents);
+        cont::sort(sortedComponents);
+        components = sortedComponents;
+    }
+
+    llvm::FoldingSetNodeID id;
+    CanonicalForm::Profile(id, components, isOrdered);
+    void *insertPos{nullptr};
+    if (CanonicalForm *form = forms_.FindNodeOrInsertPos(id, insertPos)) {
+        return form;
+    }
+
+    StatementComponent *storage =
+        allocator_.Allocate<StatementComponent>(components.size());
+    std::uninitialized_copy(components.begin(), components.end(), storage);
+    CanonicalForm *form = new (allocator_.Allocate<CanonicalForm>())
+        CanonicalForm{{storage, components.size()}, isOrdered};
+    forms_.InsertNode(form, insertPos);
+    return form;
+}
+
+}  // end of namespace: mpi
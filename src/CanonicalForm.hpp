@@ -0,0 +1,116 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef CANONICALFORM_HPP_T5MH8ZQA
+#define CANONICALFORM_HPP_T5MH8ZQA
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+
+namespace mpi {
+
+enum class ComponentType {
+    kInt,
+    kFloat,
+    kVar,
+    kFunc,
+    kComparsison,
+    kAddOp,
+    kSubOp,
+    kOperator
+};
+
+/**
+ * Component of a statement. Variables and functions are identified
+ * by their identifier, literals by value and operators by opcode.
+ */
+struct StatementComponent {
+    bool operator==(const StatementComponent &component) const {
+        return type_ == component.type_ &&
+               identity_ == component.identity_ &&
+               value_ == component.value_;
+    }
+    bool operator!=(const StatementComponent &component) const {
+        return !(*this == component);
+    }
+    bool operator<(const StatementComponent &component) const {
+        if (type_ != component.type_) return type_ < component.type_;
+        if (identity_ != component.identity_) {
+            return identity_ < component.identity_;
+        }
+        return value_ < component.value_;
+    }
+
+    ComponentType type_;
+    const void *identity_;
+    uint64_t value_;
+};
+
+/**
+ * Canonical form of a statement. Components are kept in order if the
+ * statement contains a subtraction, else they are sorted so that
+ * permutations share the same canonical form.
+ */
+class CanonicalForm : public llvm::FoldingSetNode {
+public:
+    CanonicalForm(llvm::ArrayRef<StatementComponent> components,
+                  const bool isOrdered)
+        : components_{components}, isOrdered_{isOrdered} {}
+
+    llvm::ArrayRef<StatementComponent> components() const {
+        return components_;
+    }
+    bool isOrdered() const { return isOrdered_; }
+
+    void Profile(llvm::FoldingSetNodeID &id) const {
+        Profile(id, components_, isOrdered_);
+    }
+    static void Profile(llvm::FoldingSetNodeID &,
+                        llvm::ArrayRef<StatementComponent>, const bool);
+
+private:
+    // allocated by the owning table
+    const llvm::ArrayRef<StatementComponent> components_;
+    const bool isOrdered_;
+};
+
+/**
+ * Uniquing table for canonical forms, one per translation unit.
+ * Equal statements map to the same canonical form object,
+ * so that equality can be checked by pointer comparison.
+ */
+class CanonicalFormTable {
+public:
+    const CanonicalForm *get(llvm::ArrayRef<StatementComponent>,
+                             const bool isOrdered);
+
+private:
+    llvm::FoldingSet<CanonicalForm> forms_;
+    llvm::BumpPtrAllocator allocator_;
+};
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: CANONICALFORM_HPP_T5MH8ZQA
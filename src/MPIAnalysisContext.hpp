@@ -22,39 +22,44 @@
  SOFTWARE.
 */
 
-#ifndef ARRAYVISITOR_HPP_LNSPXQ6N
-#define ARRAYVISITOR_HPP_LNSPXQ6N
+#ifndef MPIANALYSISCONTEXT_HPP_D6JW4LXP
+#define MPIANALYSISCONTEXT_HPP_D6JW4LXP
 
-#include "clang/AST/RecursiveASTVisitor.h"
+#include "llvm/ADT/SmallSet.h"
+#include "MPIArena.hpp"
 
 namespace mpi {
 
 /**
- * Visitor class to collect variables from an array.
+ * State of the ast based analysis of one translation unit.
+ * Created by every checkASTDecl invocation, so that translation units
+ * can be analysed concurrently in one process.
  */
-class ArrayVisitor : public clang::RecursiveASTVisitor<ArrayVisitor> {
+class MPIAnalysisContext {
 public:
-    ArrayVisitor(clang::VarDecl *varDecl) : arrayVarDecl_{varDecl} {
-        TraverseVarDecl(arrayVarDecl_);
-    }
-    // must be public to trigger callbacks
-    bool VisitDeclRefExpr(clang::DeclRefExpr *declRef) {
-        if (clang::VarDecl *var =
-                clang::dyn_cast<clang::VarDecl>(declRef->getDecl())) {
-            vars_.push_back(var);
+    // reset marks of all calls in all rank cases
+    void unmarkCalls() {
+        for (MPIRankCase *rankCase : rankCases_) {
+            for (RankCaseCall &call : rankCase->mpiCalls()) {
+                call.isMarked_ = false;
+            }
         }
-        return true;
     }
 
-    const clang::VarDecl *arrayVarDecl() { return arrayVarDecl_; }
-    const llvm::SmallVectorImpl<clang::VarDecl *> &vars() { return vars_; }
+    MPIArena &arena() { return arena_; }
+    // allocated in the arena
+    llvm::SmallVectorImpl<MPIRankCase *> &rankCases() { return rankCases_; }
+    llvm::SmallSet<const clang::VarDecl *, 4> &rankVariables() {
+        return rankVariables_;
+    }
 
 private:
-    // complete VarDecl
-    clang::VarDecl *arrayVarDecl_;
-    // array variables
-    llvm::SmallVector<clang::VarDecl *, 4> vars_;
+    // owns rank cases and their conditions
+    MPIArena arena_;
+    llvm::SmallVector<MPIRankCase *, 8> rankCases_;
+    llvm::SmallSet<const clang::VarDecl *, 4> rankVariables_;
 };
 
 }  // end of namespace: mpi
-#endif  // end of include guard: ARRAYVISITOR_HPP_LNSPXQ6N
+
+#endif  // end of include guard: MPIANALYSISCONTEXT_HPP_D6JW4LXP
@@ -0,0 +1,94 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef MPIARENA_HPP_Q3VZ8NCE
+#define MPIARENA_HPP_Q3VZ8NCE
+
+#include "llvm/Support/Allocator.h"
+#include "MPITypes.hpp"
+
+namespace mpi {
+
+/**
+ * Bump allocator for the objects built while analysing a translation unit.
+ * Objects get stable addresses and are destroyed all at once when the
+ * arena goes out of scope.
+ */
+class MPIArena {
+public:
+    template <typename... Args>
+    MPICall *createCall(Args &&... args) {
+        addBytes(sizeof(MPICall));
+        return new (calls_.Allocate()) MPICall(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    MPIRankCase *createRankCase(Args &&... args) {
+        addBytes(sizeof(MPIRankCase));
+        return new (rankCases_.Allocate())
+            MPIRankCase(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    StatementVisitor *createStatement(Args &&... args) {
+        addBytes(sizeof(StatementVisitor));
+        return new (statements_.Allocate())
+            StatementVisitor(std::forward<Args>(args)...);
+    }
+
+    // value initialized array of trivially destructible elements
+    template <typename T>
+    T *allocateArray(const size_t count) {
+        addBytes(count * sizeof(T));
+        T *storage = allocator_.Allocate<T>(count);
+        std::uninitialized_fill_n(storage, count, T());
+        return storage;
+    }
+
+    // copy of trivially destructible elements
+    template <typename T>
+    llvm::ArrayRef<T> copyArray(llvm::ArrayRef<T> elements) {
+        if (elements.empty()) return {};
+        addBytes(elements.size() * sizeof(T));
+        T *storage = allocator_.Allocate<T>(elements.size());
+        std::uninitialized_copy(elements.begin(), elements.end(), storage);
+        return {storage, elements.size()};
+    }
+
+    // bytes handed out, never decreasing
+    size_t bytes() const { return bytes_; }
+
+private:
+    void addBytes(const size_t bytes) { bytes_ += bytes; }
+
+    llvm::SpecificBumpPtrAllocator<MPICall> calls_;
+    llvm::SpecificBumpPtrAllocator<MPIRankCase> rankCases_;
+    llvm::SpecificBumpPtrAllocator<StatementVisitor> statements_;
+    llvm::BumpPtrAllocator allocator_;
+    size_t bytes_{0};
+};
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: MPIARENA_HPP_Q3VZ8NCE
@@ -23,7 +23,7 @@
 */
 
 #include "MPIBugReporter.hpp"
-#include "Utility.hpp"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 using namespace ento;
@@ -34,19 +34,56 @@ const std::string MPIError{"MPI Error"};
 const std::string MPIWarning{"MPI Warning"};
 
 /**
- * Get line number for call expression
+ * Get line number for call expression, resolved through the source
+ * manager without formatting the full location.
+ *
  * @param call
- * @return line number as string
+ *
+ * @return presumed line number of the expansion location, 0 if invalid
  */
-std::string MPIBugReporter::lineNumberForCallExpr(
-    const CallExpr *const call) const {
-    std::string lineNo =
-        call->getCallee()->getSourceRange().getBegin().printToString(
-            bugReporter_.getSourceManager());
-
-    // split written string into parts
-    std::vector<std::string> strs = util::split(lineNo, ':');
-    return strs.at(strs.size() - 2);
+unsigned MPIBugReporter::lineNumber(const CallExpr *const call) const {
+    const SourceManager &sourceManager = bugReporter_.getSourceManager();
+    const PresumedLoc presumedLoc = sourceManager.getPresumedLoc(
+        sourceManager.getExpansionLoc(call->getCallee()->getLocStart()));
+    return presumedLoc.isValid() ? presumedLoc.getLine() : 0;
+}
+
+/**
+ * Get name of a request for reports, e.g. "recvReq" for a variable or
+ * "requests[2]" for an array element.
+ *
+ * @param region request region
+ *
+ * @return request name
+ */
+std::string MPIBugReporter::requestName(const MemRegion *const region) const {
+    if (const VarRegion *varRegion = dyn_cast<VarRegion>(region)) {
+        return varRegion->getDecl()->getNameAsString();
+    }
+    if (const ElementRegion *element = dyn_cast<ElementRegion>(region)) {
+        std::string name = requestName(element->getSuperRegion());
+        if (auto index = element->getIndex().getAs<nonloc::ConcreteInt>()) {
+            name += "[" + index->getValue().toString(10) + "]";
+        }
+        return name;
+    }
+    return "request";
+}
+
+/**
+ * Add the declaration of the variable a request region is part of to the
+ * ranges of a report. Requests without variable, e.g. reached through a
+ * pointer, add no range.
+ *
+ * @param bugReport
+ * @param region request region
+ */
+void MPIBugReporter::addRequestRange(BugReport *const bugReport,
+                                     const MemRegion *const region) const {
+    if (const VarRegion *varRegion =
+            dyn_cast<VarRegion>(region->getBaseRegion())) {
+        bugReport->addRange(varRegion->getDecl()->getSourceRange());
+    }
 }
 
 // bug reports ––––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
@@ -70,6 +107,7 @@ void MPIBugReporter::reportNotReachableCall(
 
     bugReporter_.EmitBasicReport(adc->getDecl(), &checkerBase_, bugName,
                                  MPIError, errorText, location, range);
+    statistics_.count(MPIStatistics::kReports);
 }
 /**
  * Reports mismach between buffer type and mpi datatype.
@@ -92,6 +130,7 @@ void MPIBugReporter::reportTypeMismatch(
 
     bugReporter_.EmitBasicReport(adc->getDecl(), &checkerBase_, bugName,
                                  MPIError, errorText, location, sourceRanges);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
@@ -112,6 +151,7 @@ void MPIBugReporter::reportCollCallInBranch(
 
     bugReporter_.EmitBasicReport(adc->getDecl(), &checkerBase_, bugName,
                                  MPIError, errorText, location, range);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
@@ -132,6 +172,7 @@ void MPIBugReporter::reportUnmatchedCall(const CallExpr *const callExpr,
 
     bugReporter_.EmitBasicReport(adc->getDecl(), &checkerBase_, bugName,
                                  MPIError, errorText, location, range);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
@@ -159,6 +200,7 @@ void MPIBugReporter::reportInvalidArgumentType(
                                  errorText, location,
                                  {callExprRange, invalidSourceRange,
                                   callExpr->getArg(idx)->getSourceRange()});
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
@@ -177,24 +219,24 @@ void MPIBugReporter::reportRedundantCall(
     PathDiagnosticLocation location = PathDiagnosticLocation::createBegin(
         duplicateCall, bugReporter_.getSourceManager(), analysisDeclCtx);
 
-    std::string lineNo = lineNumberForCallExpr(matchedCall);
-
     // build source ranges vector
     SmallVector<SourceRange, 10> sourceRanges;
     sourceRanges.push_back(matchedCall->getCallee()->getSourceRange());
     sourceRanges.push_back(duplicateCall->getCallee()->getSourceRange());
 
-    std::string redundantCallName{
-        matchedCall->getDirectCallee()->getNameAsString()};
-
     std::string bugName{"duplicate calls"};
-    std::string errorText{"Identical communication arguments used in " +
-                          redundantCallName + " in line " + lineNo +
-                          ".\nConsider to summarize these calls. "};
+    std::string errorText;
+    llvm::raw_string_ostream errorStream{errorText};
+    errorStream << "Identical communication arguments used in "
+                << matchedCall->getDirectCallee()->getName() << " in line "
+                << lineNumber(matchedCall)
+                << ".\nConsider to summarize these calls. ";
+    errorStream.flush();
 
     bugReporter_.EmitBasicReport(analysisDeclCtx->getDecl(), &checkerBase_,
                                  bugName, MPIWarning, errorText, location,
                                  sourceRanges);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 // path sensitive reports –––––––––––––––––––––––––––––––––––––––––––––––––
@@ -202,90 +244,102 @@ void MPIBugReporter::reportRedundantCall(
  * Report duplicate request use by nonblocking calls.
  *
  * @param observedCall
- * @param requestVar
+ * @param requestRegion
+ * @param lastUser call that last used the request
  * @param node
  */
 void MPIBugReporter::reportDoubleNonblocking(
-    const CallExpr *const observedCall, const RequestVar &requestVar,
-    const ExplodedNode *const node) const {
-    std::string lineNo{lineNumberForCallExpr(requestVar.lastUser_)};
-    std::string lastUser =
-        requestVar.lastUser_->getDirectCallee()->getNameAsString();
-    std::string errorText{"Request " + requestVar.varDecl_->getNameAsString() +
-                          " is already in use by nonblocking call " + lastUser +
-                          " in line " + lineNo + ". "};
+    const CallExpr *const observedCall, const MemRegion *const requestRegion,
+    const CallExpr *const lastUser, const ExplodedNode *const node) const {
+    std::string errorText;
+    llvm::raw_string_ostream errorStream{errorText};
+    errorStream << "Request " << requestName(requestRegion)
+                << " is already in use by nonblocking call "
+                << lastUser->getDirectCallee()->getName()
+                << " in line " << lineNumber(lastUser) << ". ";
+    errorStream.flush();
 
     BugReport *bugReport =
-        new BugReport(*doubleNonblockingBugType_, errorText, node);
+        new BugReport(bugTypes_.doubleNonblocking_, errorText, node);
     bugReport->addRange(observedCall->getSourceRange());
-    bugReport->addRange(requestVar.varDecl_->getSourceRange());
-    bugReport->addRange(requestVar.lastUser_->getSourceRange());
+    addRequestRange(bugReport, requestRegion);
+    bugReport->addRange(lastUser->getSourceRange());
     bugReporter_.emitReport(bugReport);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
  * Report duplicate request use by waits.
  *
  * @param observedCall
- * @param requestVar
+ * @param requestRegion
+ * @param lastUser call that last used the request
  * @param node
  */
 void MPIBugReporter::reportDoubleWait(const CallExpr *const observedCall,
-                                      const RequestVar &requestVar,
+                                      const MemRegion *const requestRegion,
+                                      const CallExpr *const lastUser,
                                       const ExplodedNode *const node) const {
-    std::string lineNo{lineNumberForCallExpr(requestVar.lastUser_)};
-    std::string lastUser =
-        requestVar.lastUser_->getDirectCallee()->getNameAsString();
-    std::string errorText{"Request " + requestVar.varDecl_->getNameAsString() +
-                          " is already waited upon by " + lastUser +
-                          " in line " + lineNo + ". "};
-
-    BugReport *bugReport = new BugReport(*doubleWaitBugType_, errorText, node);
+    std::string errorText;
+    llvm::raw_string_ostream errorStream{errorText};
+    errorStream << "Request " << requestName(requestRegion)
+                << " is already waited upon by "
+                << lastUser->getDirectCallee()->getName()
+                << " in line " << lineNumber(lastUser) << ". ";
+    errorStream.flush();
+
+    BugReport *bugReport =
+        new BugReport(bugTypes_.doubleWait_, errorText, node);
     bugReport->addRange(observedCall->getSourceRange());
-    bugReport->addRange(requestVar.varDecl_->getSourceRange());
-    bugReport->addRange(requestVar.lastUser_->getSourceRange());
+    addRequestRange(bugReport, requestRegion);
+    bugReport->addRange(lastUser->getSourceRange());
     bugReporter_.emitReport(bugReport);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
  * Report a missing wait for a nonblocking call.
  *
- * @param requestVar
+ * @param requestRegion
+ * @param lastUser nonblocking call that used the request
  * @param node
  */
-void MPIBugReporter::reportMissingWait(const RequestVar &requestVar,
+void MPIBugReporter::reportMissingWait(const MemRegion *const requestRegion,
+                                       const CallExpr *const lastUser,
                                        const ExplodedNode *const node) const {
     std::string errorText{"Nonblocking call using request " +
-                          requestVar.varDecl_->getNameAsString() +
+                          requestName(requestRegion) +
                           " has no matching wait. "};
 
-    PathDiagnosticLocation p{requestVar.lastUser_->getLocStart(),
+    PathDiagnosticLocation p{lastUser->getLocStart(),
                              analysisManager_.getSourceManager()};
 
-    BugReport *bugReport = new BugReport(*missingWaitBugType_, errorText, p);
-    bugReport->addRange(requestVar.lastUser_->getSourceRange());
-    bugReport->addRange(requestVar.varDecl_->getSourceRange());
+    BugReport *bugReport = new BugReport(bugTypes_.missingWait_, errorText, p);
+    bugReport->addRange(lastUser->getSourceRange());
+    addRequestRange(bugReport, requestRegion);
     bugReporter_.emitReport(bugReport);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 /**
- * Report there's no matching nonblocking call for request var used by wait.
+ * Report there's no matching nonblocking call for request used by wait.
  *
  * @param callExpr
- * @param requestVar
+ * @param requestRegion
  * @param node
  */
 void MPIBugReporter::reportUnmatchedWait(const CallExpr *callExpr,
-                                         const VarDecl *requestVar,
+                                         const MemRegion *requestRegion,
                                          const ExplodedNode *const node) const {
-    std::string errorText{"Request " + requestVar->getNameAsString() +
+    std::string errorText{"Request " + requestName(requestRegion) +
                           " has no matching nonblocking call. "};
 
     BugReport *bugReport =
-        new BugReport(*unmatchedWaitBugType_, errorText, node);
+        new BugReport(bugTypes_.unmatchedWait_, errorText, node);
     bugReport->addRange(callExpr->getSourceRange());
-    bugReport->addRange(requestVar->getSourceRange());
+    addRequestRange(bugReport, requestRegion);
     bugReporter_.emitReport(bugReport);
+    statistics_.count(MPIStatistics::kReports);
 }
 
 }  // end of namespace: mpi
@@ -27,9 +27,28 @@
 
 #include "clang/StaticAnalyzer/Core/BugReporter/BugType.h"
 #include "MPITypes.hpp"
+#include "MPIStatistics.hpp"
 
 namespace mpi {
 
+/**
+ * Bug types used by the path sensitive reports.
+ * Created once per translation unit and shared by all reporters.
+ */
+struct MPIBugTypes {
+    MPIBugTypes(const clang::ento::CheckerBase &checkerBase)
+        : unmatchedWait_{&checkerBase, "unmatched wait", "MPI Error"},
+          missingWait_{&checkerBase, "missing wait", "MPI Error"},
+          doubleWait_{&checkerBase, "double wait", "MPI Error"},
+          doubleNonblocking_{&checkerBase, "double request usage",
+                             "MPI Error"} {}
+
+    clang::ento::BugType unmatchedWait_;
+    clang::ento::BugType missingWait_;
+    clang::ento::BugType doubleWait_;
+    clang::ento::BugType doubleNonblocking_;
+};
+
 /**
  * Emits bug reports for ast and path sensitive checks.
  */
@@ -37,19 +56,13 @@ class MPIBugReporter {
 public:
     MPIBugReporter(clang::ento::BugReporter &bugReporter,
                    const clang::ento::CheckerBase &checkerBase,
-                   clang::ento::AnalysisManager &analysisManager)
+                   clang::ento::AnalysisManager &analysisManager,
+                   MPIBugTypes &bugTypes, MPIStatistics &statistics)
         : bugReporter_{bugReporter},
           checkerBase_{checkerBase},
-          analysisManager_{analysisManager} {
-        doubleWaitBugType_.reset(
-            new clang::ento::BugType(&checkerBase, "double wait", "MPI Error"));
-        unmatchedWaitBugType_.reset(new clang::ento::BugType(
-            &checkerBase, "unmatched wait", "MPI Error"));
-        doubleNonblockingBugType_.reset(new clang::ento::BugType(
-            &checkerBase, "double request usage", "MPI Error"));
-        missingWaitBugType_.reset(new clang::ento::BugType(
-            &checkerBase, "missing wait", "MPI Error"));
-    }
+          analysisManager_{analysisManager},
+          bugTypes_{bugTypes},
+          statistics_{statistics} {}
 
     // ast reports ––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
     void reportTypeMismatch(const clang::CallExpr *const,
@@ -65,34 +78,38 @@ public:
     void reportNotReachableCall(const clang::CallExpr *const) const;
 
     // path sensitive reports –––––––––––––––––––––––––––––––––––––––––––––––
-    void reportMissingWait(const RequestVar &,
+    void reportMissingWait(const clang::ento::MemRegion *const,
+                           const clang::CallExpr *const,
                            const clang::ento::ExplodedNode *const) const;
 
     void reportUnmatchedWait(const clang::CallExpr *const,
-                             const clang::VarDecl *const,
+                             const clang::ento::MemRegion *const,
                              const clang::ento::ExplodedNode *const) const;
 
-    void reportDoubleWait(const clang::CallExpr *, const RequestVar &,
+    void reportDoubleWait(const clang::CallExpr *,
+                          const clang::ento::MemRegion *const,
+                          const clang::CallExpr *const,
                           const clang::ento::ExplodedNode *const) const;
 
     void reportDoubleNonblocking(const clang::CallExpr *const,
-                                 const RequestVar &,
+                                 const clang::ento::MemRegion *const,
+                                 const clang::CallExpr *const,
                                  const clang::ento::ExplodedNode *const) const;
 
     const clang::Decl *currentFunctionDecl_{nullptr};
 
 private:
-    std::string lineNumberForCallExpr(const clang::CallExpr *const) const;
-
-    // path sensitive bug types
-    std::unique_ptr<clang::ento::BugType> unmatchedWaitBugType_;
-    std::unique_ptr<clang::ento::BugType> missingWaitBugType_;
-    std::unique_ptr<clang::ento::BugType> doubleWaitBugType_;
-    std::unique_ptr<clang::ento::BugType> doubleNonblockingBugType_;
+    unsigned lineNumber(const clang::CallExpr *const) const;
+    std::string requestName(const clang::ento::MemRegion *const) const;
+    void addRequestRange(clang::ento::BugReport *const,
+                         const clang::ento::MemRegion *const) const;
 
     clang::ento::BugReporter &bugReporter_;
     const clang::ento::CheckerBase &checkerBase_;
     clang::ento::AnalysisManager &analysisManager_;
+    // path sensitive bug types
+    MPIBugTypes &bugTypes_;
+    MPIStatistics &statistics_;
 };
 
 }  // end of namespace: mpi
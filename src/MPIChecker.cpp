@@ -24,13 +24,161 @@
 
 #include "TranslationUnitVisitor.hpp"
 #include "MPICheckerPathSensitive.hpp"
-#include "RankVisitor.hpp"
+#include "MPISharedContext.hpp"
+#include "llvm/Support/Path.h"
 
 using namespace clang;
 using namespace ento;
 
 namespace mpi {
 
+/**
+ * Keeps the context shared by all checks of a checker.
+ * Created lazily, once per ast context.
+ */
+class SharedContextOwner {
+public:
+    /**
+     * Returns the context shared by all checks.
+     *
+     * @param analysisManager
+     * @param checkerBase checker the bug types are registered for
+     *
+     * @return shared context
+     */
+    MPISharedContext &sharedContext(AnalysisManager &analysisManager,
+                                    const CheckerBase &checkerBase) const {
+        if (!sharedContext_ ||
+            &sharedContext_->astContext() != &analysisManager.getASTContext()) {
+            sharedContext_.reset(
+                new MPISharedContext{analysisManager, checkerBase});
+        }
+        return *sharedContext_;
+    }
+
+private:
+    mutable std::unique_ptr<MPISharedContext> sharedContext_;
+};
+
+// analyzer-config option enabling cross translation unit matching
+const char kSummaryDirOption[] = "mpi-summary-dir";
+
+/**
+ * Writes the summary of a translation unit to the summary directory.
+ * The file name is derived from the main file, so that reanalysing a
+ * translation unit replaces its summary.
+ *
+ * @param summary
+ * @param summaryDir
+ * @param sourceManager
+ */
+void writeSummary(const MPISummary &summary, const std::string &summaryDir,
+                  const SourceManager &sourceManager) {
+    const FileEntry *mainFile =
+        sourceManager.getFileEntryForID(sourceManager.getMainFileID());
+    const StringRef mainFilePath{mainFile ? mainFile->getName() : ""};
+
+    SmallString<128> summaryPath{summaryDir};
+    llvm::sys::path::append(summaryPath, summaryFileName(mainFilePath.str()));
+    if (!summary.write(summaryPath.str().str())) {
+        llvm::errs() << "MPI-Checker: could not write summary "
+                     << summaryPath << "\n";
+    }
+}
+
+/**
+ * Runs the ast based checks for a translation unit.
+ *
+ * @param tuDecl
+ * @param analysisManager
+ * @param bugReporter
+ * @param checkerBase checker reporting the bugs
+ * @param sharedContext
+ */
+void checkTranslationUnit(const TranslationUnitDecl *tuDecl,
+                          AnalysisManager &analysisManager,
+                          BugReporter &bugReporter,
+                          const CheckerBase &checkerBase,
+                          MPISharedContext &sharedContext) {
+    using Timer = MPIStatistics::PhaseTimer;
+    MPIStatistics &statistics = sharedContext.statistics();
+    // owns rank cases and rank variables of the translation unit
+    MPIAnalysisContext analysisContext;
+
+    // traverse translation unit ast once
+    TranslationUnitVisitor visitor{bugReporter, checkerBase, analysisManager,
+                                   sharedContext, analysisContext};
+    {
+        Timer timer{statistics, MPIStatistics::kTraversal};
+        visitor.TraverseTranslationUnitDecl(
+            const_cast<TranslationUnitDecl *>(tuDecl));
+    }
+    // rank variables are known now
+    {
+        Timer timer{statistics, MPIStatistics::kCollectRankCases};
+        visitor.collectRankCases();
+    }
+    statistics.count(MPIStatistics::kRankCases,
+                     analysisContext.rankCases().size());
+
+    // check after tu traversal
+    const std::string summaryDir{
+        analysisManager.getAnalyzerOptions().Config.lookup(kSummaryDirOption)};
+    if (summaryDir.empty()) {
+        {
+            Timer timer{statistics, MPIStatistics::kPointToPointSchema};
+            visitor.checkerAST_.checkPointToPointSchema();
+        }
+        Timer timer{statistics, MPIStatistics::kReachability};
+        visitor.checkerAST_.checkReachbility();
+    } else {
+        // partners may be located in other translation units,
+        // schema and reachability are checked when summaries are merged
+        writeSummary(visitor.checkerAST_.summary(), summaryDir,
+                     analysisManager.getSourceManager());
+    }
+    // visitor.checkerAST_.checkForRedundantCalls();
+
+    // the arena of the analysis context is released after the ast checks
+    statistics.recordArenaBytes(analysisContext.arena().bytes() +
+                                sharedContext.callArenaBytes());
+}
+
+/**
+ * Prints the timers of a translation unit if -analyzer-stats is passed
+ * and writes timers and counters as json to the statistics directory.
+ * The file name is derived from the main file like the summary name.
+ *
+ * @param analysisManager
+ * @param sharedContext
+ */
+void reportStatistics(AnalysisManager &analysisManager,
+                      MPISharedContext &sharedContext) {
+    MPIStatistics &statistics = sharedContext.statistics();
+    // calls described by the path sensitive checks
+    statistics.recordArenaBytes(sharedContext.callArenaBytes());
+
+    const AnalyzerOptions &analyzerOptions =
+        analysisManager.getAnalyzerOptions();
+    if (analyzerOptions.PrintStats) statistics.print(llvm::errs());
+
+    const std::string statsDir{
+        analyzerOptions.Config.lookup(kStatsDirOption)};
+    if (statsDir.empty()) return;
+    const SourceManager &sourceManager = analysisManager.getSourceManager();
+    const FileEntry *mainFile =
+        sourceManager.getFileEntryForID(sourceManager.getMainFileID());
+    const std::string mainFilePath{mainFile ? mainFile->getName() : ""};
+
+    SmallString<128> statsPath{statsDir};
+    llvm::sys::path::append(statsPath, summaryFileName(mainFilePath));
+    llvm::sys::path::replace_extension(statsPath, "json");
+    if (!statistics.writeJSON(statsPath.str().str(), mainFilePath)) {
+        llvm::errs() << "MPI-Checker: could not write statistics "
+                     << statsPath << "\n";
+    }
+}
+
 /**
  * Main class which serves as an entry point for analysis.
  * Class name determines checker name to specify on the command line.
@@ -38,63 +186,118 @@ namespace mpi {
  */
 class MPIChecker
     : public Checker<check::ASTDecl<TranslationUnitDecl>,
-                     check::PreStmt<CallExpr>, check::EndFunction> {
+                     check::PreStmt<CallExpr>, check::PostStmt<CallExpr>,
+                     check::DeadSymbols, check::EndFunction,
+                     check::EndOfTranslationUnit> {
 public:
     // ast callback–––––––––––––––––––––––––––––––––––––––––––––––––––––––
     void checkASTDecl(const TranslationUnitDecl *tuDecl,
                       AnalysisManager &analysisManager,
                       BugReporter &bugReporter) const {
-        // identify rank variables first
-        RankVisitor rankVisitor{analysisManager};
-        rankVisitor.TraverseTranslationUnitDecl(
-            const_cast<TranslationUnitDecl *>(tuDecl));
-
-        // traverse translation unit ast
-        TranslationUnitVisitor visitor{bugReporter, *this, analysisManager};
-        visitor.TraverseTranslationUnitDecl(
-            const_cast<TranslationUnitDecl *>(tuDecl));
-
-        // check after tu traversal
-        visitor.checkerAST_.checkPointToPointSchema();
-        visitor.checkerAST_.checkReachbility();
-        // visitor.checkerAST_.checkForRedundantCalls();
-
-        // clear after every translation unit
-        MPIRank::visitedRankVariables.clear();
-        MPIRankCase::visitedRankCases.clear();
+        checkTranslationUnit(tuDecl, analysisManager, bugReporter, *this,
+                             sharedContext(analysisManager));
     }
 
     // path sensitive callbacks––––––––––––––––––––––––––––––––––––––––––––
     void checkPreStmt(const CallExpr *callExpr, CheckerContext &ctx) const {
-        dynamicInit(ctx);
-        checkerSens_->checkWaitUsage(callExpr, ctx);
-        checkerSens_->checkDoubleNonblocking(callExpr, ctx);
+        MPIStatistics::PhaseTimer timer{statistics(ctx),
+                                        MPIStatistics::kPreStmt};
+        MPICheckerPathSensitive checkerSens{pathSensitive(ctx)};
+        checkerSens.checkWaitUsage(callExpr, ctx);
+        checkerSens.checkPartialCompletion(callExpr, ctx);
+        checkerSens.checkTestUsage(callExpr, ctx);
+        checkerSens.checkDoubleNonblocking(callExpr, ctx);
+    }
+
+    void checkPostStmt(const CallExpr *callExpr, CheckerContext &ctx) const {
+        MPIStatistics::PhaseTimer timer{statistics(ctx),
+                                        MPIStatistics::kPostStmt};
+        MPICheckerPathSensitive checkerSens{pathSensitive(ctx)};
+        checkerSens.checkTestFlag(callExpr, ctx);
+    }
+
+    void checkDeadSymbols(SymbolReaper &symbolReaper,
+                          CheckerContext &ctx) const {
+        MPIStatistics::PhaseTimer timer{statistics(ctx),
+                                        MPIStatistics::kDeadSymbols};
+        MPICheckerPathSensitive checkerSens{pathSensitive(ctx)};
+        checkerSens.checkDeadRequests(symbolReaper, ctx);
     }
 
     void checkEndFunction(CheckerContext &ctx) const {
+        MPIStatistics::PhaseTimer timer{statistics(ctx),
+                                        MPIStatistics::kEndFunction};
+        // requests of the top frame still tracked, e.g. globals
         // true if the current LocationContext has no caller context
         if (ctx.inTopFrame()) {
-            dynamicInit(ctx);
-            checkerSens_->checkMissingWaits(ctx);
-            checkerSens_->clearRequestVars(ctx);
+            MPICheckerPathSensitive checkerSens{pathSensitive(ctx)};
+            checkerSens.checkMissingWaits(ctx);
+            checkerSens.clearRequestVars(ctx);
         }
     }
 
+    void checkEndOfTranslationUnit(const TranslationUnitDecl *,
+                                   AnalysisManager &analysisManager,
+                                   BugReporter &) const {
+        reportStatistics(analysisManager, sharedContext(analysisManager));
+    }
+
 private:
-    const std::unique_ptr<MPICheckerPathSensitive> checkerSens_;
+    SharedContextOwner sharedContextOwner_;
 
-    void dynamicInit(CheckerContext &ctx) const {
-        if (!checkerSens_) {
-            const_cast<std::unique_ptr<MPICheckerPathSensitive> &>(checkerSens_)
-                .reset(new MPICheckerPathSensitive(ctx.getAnalysisManager(),
-                                                   this, ctx.getBugReporter()));
-        }
+    MPISharedContext &sharedContext(AnalysisManager &analysisManager) const {
+        return sharedContextOwner_.sharedContext(analysisManager, *this);
+    }
+
+    MPIStatistics &statistics(CheckerContext &ctx) const {
+        return sharedContext(ctx.getAnalysisManager()).statistics();
+    }
+
+    /**
+     * Path sensitive checks are bound to the bug reporter of the current
+     * exploded graph, which is why they are not kept across callbacks.
+     */
+    MPICheckerPathSensitive pathSensitive(CheckerContext &ctx) const {
+        return {ctx.getAnalysisManager(), *this, ctx.getBugReporter(),
+                sharedContext(ctx.getAnalysisManager())};
     }
 };
 
+/**
+ * Runs only the ast based checks of the MPIChecker. Having no path
+ * sensitive callbacks, enabling it alone skips path exploration
+ * entirely, which is what the mpi-check driver relies on.
+ */
+class MPIASTChecker : public Checker<check::ASTDecl<TranslationUnitDecl>,
+                                     check::EndOfTranslationUnit> {
+public:
+    void checkASTDecl(const TranslationUnitDecl *tuDecl,
+                      AnalysisManager &analysisManager,
+                      BugReporter &bugReporter) const {
+        checkTranslationUnit(
+            tuDecl, analysisManager, bugReporter, *this,
+            sharedContextOwner_.sharedContext(analysisManager, *this));
+    }
+
+    void checkEndOfTranslationUnit(const TranslationUnitDecl *,
+                                   AnalysisManager &analysisManager,
+                                   BugReporter &) const {
+        reportStatistics(
+            analysisManager,
+            sharedContextOwner_.sharedContext(analysisManager, *this));
+    }
+
+private:
+    SharedContextOwner sharedContextOwner_;
+};
+
 }  // end of namespace: mpi
 
-// registers the checker for static analysis.
+// registers the checkers for static analysis.
 void ento::registerMPIChecker(CheckerManager &mgr) {
     mgr.registerChecker<mpi::MPIChecker>();
 }
+
+void ento::registerMPIASTChecker(CheckerManager &mgr) {
+    mgr.registerChecker<mpi::MPIASTChecker>();
+}
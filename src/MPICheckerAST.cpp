@@ -23,6 +23,9 @@
 */
 
 #include "MPICheckerAST.hpp"
+#include "PointToPointMatcher.hpp"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 using namespace ento;
@@ -30,225 +33,306 @@ using namespace ento;
 namespace mpi {
 
 /**
- * Checks if point to point functions resolve to a valid schema.
+ * Rank cases of the translation unit, described for PointToPointMatcher.
  */
-void MPICheckerAST::checkPointToPointSchema() const {
-    MPIRankCase::unmarkCalls();
-
-    // search send/recv pairs for interacting cases
-    for (MPIRankCase &rankCase1 : MPIRankCase::visitedRankCases) {
-        for (MPIRankCase &rankCase2 : MPIRankCase::visitedRankCases) {
-            // rank conditions must be distinct or ambiguous
-            if (!rankCase1.isConditionUnambiguouslyEqual(rankCase2)) {
-                // rank cases are potential partner
-                checkSendRecvMatches(rankCase1, rankCase2);
-            }
-        }
+class MPICheckerAST::RankCaseSchema {
+public:
+    using Key = MatchKey;
+    using KeyHash = MatchKeyHash;
+
+    explicit RankCaseSchema(const MPICheckerAST &checkerAST)
+        : checkerAST_{checkerAST},
+          rankCases_{checkerAST.analysisContext_.rankCases()} {}
+
+    size_t caseCount() const { return rankCases_.size(); }
+    size_t callCount(const size_t rankCase) const {
+        return rankCases_[rankCase]->size();
+    }
+    bool isConditionUnambiguouslyEqual(const size_t first,
+                                       const size_t second) const {
+        return rankCases_[first]->isConditionUnambiguouslyEqual(
+            *rankCases_[second]);
+    }
+    bool isSend(const size_t rankCase, const size_t idx) const {
+        return checkerAST_.funcClassifier_.isSendType(call(rankCase, idx));
+    }
+    bool isRecv(const size_t rankCase, const size_t idx) const {
+        return checkerAST_.funcClassifier_.isRecvType(call(rankCase, idx));
+    }
+    bool isBlocking(const size_t rankCase, const size_t idx) const {
+        return checkerAST_.funcClassifier_.isBlockingType(call(rankCase, idx));
+    }
+    const MatchKey *matchKey(const size_t rankCase, const size_t idx) const {
+        const MatchKey &key =
+            checkerAST_.matchKey(*call(rankCase, idx).mpiCall_);
+        return key.isValid() ? &key : nullptr;
     }
 
-    // trigger report for unmarked
-    for (const MPIRankCase &rankCase : MPIRankCase::visitedRankCases) {
-        for (const MPICall &call : rankCase.mpiCalls()) {
-            if (funcClassifier_.isSendType(call) && !call.isMarked_) {
-                bugReporter_.reportUnmatchedCall(call.callExpr(), "receive");
-            } else if (funcClassifier_.isRecvType(call) && !call.isMarked_) {
-                bugReporter_.reportUnmatchedCall(call.callExpr(), "send");
-            }
-        }
+    void reportUnmatchedCall(const size_t rankCase, const size_t idx) const {
+        checkerAST_.bugReporter_.reportUnmatchedCall(
+            call(rankCase, idx).callExpr(),
+            isSend(rankCase, idx) ? "receive" : "send");
+    }
+    void reportUnreachableCall(const size_t rankCase, const size_t idx) const {
+        checkerAST_.bugReporter_.reportNotReachableCall(
+            call(rankCase, idx).callExpr());
+    }
+
+private:
+    const RankCaseCall &call(const size_t rankCase, const size_t idx) const {
+        return rankCases_[rankCase]->mpiCalls()[idx];
     }
-}
+
+    const MPICheckerAST &checkerAST_;
+    const llvm::SmallVectorImpl<MPIRankCase *> &rankCases_;
+};
 
 /**
- * Matches send with recv operations between two rank cases.
- * For the first case send operations are tried to be matched
- * with recv operations from the second case. In case of a match
- * calls are marked.
- *
- * @param rankCase1
- * @param rankCase2
+ * Checks if point to point functions resolve to a valid schema.
  */
-void MPICheckerAST::checkSendRecvMatches(const MPIRankCase &firstCase,
-                                         const MPIRankCase &secondCase) const {
-    // find send/recv pairs
-    for (const MPICall &send : firstCase.mpiCalls()) {
-        // skip non sends for case 1
-        if (!funcClassifier_.isSendType(send) || send.isMarked_) continue;
-
-        // skip non recvs for case 2
-        for (const MPICall &recv : secondCase.mpiCalls()) {
-            if (!funcClassifier_.isRecvType(recv) || recv.isMarked_) continue;
-
-            // check if pair matches
-            if (isSendRecvPair(send, recv)) {
-                send.isMarked_ = true;
-                recv.isMarked_ = true;
-                break;
-            }
-        }
-    }
+void MPICheckerAST::checkPointToPointSchema() const {
+    RankCaseSchema schema{*this};
+    PointToPointMatcher<RankCaseSchema>{schema}.checkPointToPointSchema();
 }
 
 /**
  * Check if mpi functions can be reached.
  */
 void MPICheckerAST::checkReachbility() const {
-    MPIRankCase::unmarkCalls();
-
-    // multiple send/recv phases per rank case are allowed
-    for (int i = 0; i < 4; ++i) {
-        // search send/recv pairs for interacting cases
-        for (MPIRankCase &rankCase1 : MPIRankCase::visitedRankCases) {
-            for (MPIRankCase &rankCase2 : MPIRankCase::visitedRankCases) {
-                // rank conditions must be distinct or ambiguous
-                if (!rankCase1.isConditionUnambiguouslyEqual(rankCase2)) {
-                    // rank cases are potential partner
-                    checkReachbilityPair(rankCase1, rankCase2);
-                }
-            }
+    RankCaseSchema schema{*this};
+    PointToPointMatcher<RankCaseSchema> matcher{schema};
+    matcher.checkReachability();
+    statistics_.count(MPIStatistics::kSendRecvPairChecks,
+                      matcher.pairChecks());
+}
+
+/**
+ * Checks if a collective call. Triggers bug reporter.
+ *
+ * @param mpiCall
+ */
+void MPICheckerAST::checkForCollectiveCalls(const MPIRankCase &rankCase) const {
+    for (const RankCaseCall &call : rankCase.mpiCalls()) {
+        if (funcClassifier_.isCollectiveType(call)) {
+            bugReporter_.reportCollCallInBranch(call.callExpr());
         }
     }
+}
 
-    // trigger report for unreached
-    for (const MPIRankCase &rankCase : MPIRankCase::visitedRankCases) {
-        for (const MPICall &call : rankCase.mpiCalls()) {
-            if (funcClassifier_.isMPIType(call) && !call.isReachable_) {
-                bugReporter_.reportNotReachableCall(call.callExpr());
-            }
-        }
+/**
+ * Returns the match key of a point to point call, built on first use.
+ *
+ * @param mpiCall
+ *
+ * @return match key
+ */
+const MPICheckerAST::MatchKey &MPICheckerAST::matchKey(
+    const MPICall &mpiCall) const {
+    auto it = matchKeys_.find(mpiCall.callExpr());
+    if (it == matchKeys_.end()) {
+        it = matchKeys_.emplace(mpiCall.callExpr(), buildMatchKey(mpiCall))
+                 .first;
     }
+    return it->second;
+}
+
+bool MPICheckerAST::MatchKey::operator==(const MatchKey &key) const {
+    return datatype_ == key.datatype_ &&
+           derivedDatatype_ == key.derivedDatatype_ && count_ == key.count_ &&
+           tag_ == key.tag_ && rankTail_ == key.rankTail_ &&
+           rankLastOperand_ == key.rankLastOperand_ &&
+           isAddition_ == key.isAddition_;
+}
+
+size_t MPICheckerAST::MatchKeyHash::operator()(const MatchKey &key) const {
+    return llvm::hash_combine(
+        static_cast<unsigned>(key.datatype_), key.derivedDatatype_,
+        key.count_, key.tag_, key.rankTail_,
+        static_cast<unsigned>(key.rankLastOperand_.type_),
+        key.rankLastOperand_.identity_, key.rankLastOperand_.value_,
+        key.isAddition_);
 }
 
 /**
- * Check for reachability of calls between to cases.
+ * Builds the key used to match point to point calls. A send and a recv
+ * call are a pair if and only if their keys are equal. The key consists of
+ * datatype, count, tag and the rank argument without its last operator.
+ * Operands are compared as permutation if no subtraction is involved.
+ * The last operator of the rank must be inverse, which is why receives
+ * use the inverse operator in their key.
+ *
+ * @param mpiCall
  *
- * @param firstCase
- * @param secondCase
+ * @return match key, invalid if the call can not be matched
  */
-void MPICheckerAST::checkReachbilityPair(const MPIRankCase &firstCase,
-                                         const MPIRankCase &secondCase) const {
-    // find send/recv pairs
-    for (const MPICall &send : firstCase.mpiCalls()) {
-        send.isReachable_ = true;
-        if (send.isMarked_) continue;
-
-        for (const MPICall &recv : secondCase.mpiCalls()) {
-            recv.isReachable_ = true;
-            if (recv.isMarked_) continue;
-
-            // check if pair matches
-            if (isSendRecvPair(send, recv)) {
-                send.isMarked_ = true;
-                recv.isMarked_ = true;
-                break;
-            }
-            // no match and call was blocking
-            else if (funcClassifier_.isBlockingType(recv)) {
-                break;
-            }
-        }
+MPICheckerAST::MatchKey MPICheckerAST::buildMatchKey(
+    const MPICall &mpiCall) const {
+    MatchKey key{MPIDatatype::kUnknown, nullptr, nullptr, nullptr, nullptr,
+                 StatementComponent{ComponentType::kOperator, nullptr, 0},
+                 false};
+
+    const bool isSend = funcClassifier_.isSendType(mpiCall);
+    if (!isSend && !funcClassifier_.isRecvType(mpiCall)) return key;
+
+    // last operator of the rank must be an addition or subtraction
+    const auto &rankArg = mpiCall.argument(MPIPointToPoint::kRank);
+    if (rankArg.binaryOperators().empty()) return key;
+    const BinaryOperatorKind lastOperator = rankArg.binaryOperators().front();
+    if (lastOperator != BinaryOperatorKind::BO_Add &&
+        lastOperator != BinaryOperatorKind::BO_Sub) {
+        return key;
+    }
+    if (rankArg.components().size() < 2) return key;
 
-        // no matching recv found in second case
-        if (funcClassifier_.isBlockingType(send) && !send.isMarked_) {
-            return;
-        }
+    // compare mpi datatype
+    key.datatype_ = datatypes_.resolve(
+        mpiCall.callExpr()->getArg(MPIPointToPoint::kDatatype));
+    if (key.datatype_ == MPIDatatype::kUnknown) {
+        key.derivedDatatype_ =
+            mpiCall.argument(MPIPointToPoint::kDatatype).canonicalForm();
     }
+
+    // compare count, tag
+    key.count_ = mpiCall.argument(MPIPointToPoint::kCount).canonicalForm();
+    key.tag_ = mpiCall.argument(MPIPointToPoint::kTag).canonicalForm();
+
+    // compare rank sequence without last operator (skip first element)
+    llvm::ArrayRef<StatementComponent> rankTail =
+        rankArg.components().slice(1);
+    const bool containsSubtraction =
+        cont::isContainedPred(rankTail, [](const StatementComponent &c) {
+            return c.type_ == ComponentType::kSubOp;
+        });
+    key.rankTail_ = canonicalForms_.get(rankTail, containsSubtraction);
+    // last (value|var|function) must be identical
+    key.rankLastOperand_ = rankTail.back();
+
+    // last operator must be inverse
+    const bool isAddition = lastOperator == BinaryOperatorKind::BO_Add;
+    key.isAddition_ = isAddition == isSend;
+
+    return key;
 }
 
+namespace {
+
 /**
- * Checks if a collective call. Triggers bug reporter.
+ * Renders a component independent of the translation unit,
+ * identifying variables and functions by name.
  *
- * @param mpiCall
+ * @param component
+ *
+ * @return portable text
  */
-void MPICheckerAST::checkForCollectiveCalls(const MPIRankCase &rankCase) const {
-    for (const MPICall &call : rankCase.mpiCalls()) {
-        if (funcClassifier_.isCollectiveType(call)) {
-            bugReporter_.reportCollCallInBranch(call.callExpr());
+std::string portableText(const StatementComponent &component) {
+    std::string text;
+    llvm::raw_string_ostream textStream{text};
+    textStream << static_cast<unsigned>(component.type_) << ':';
+    if (component.type_ == ComponentType::kVar ||
+        component.type_ == ComponentType::kFunc) {
+        if (component.identity_) {
+            textStream << static_cast<const IdentifierInfo *>(
+                              component.identity_)->getName();
         }
+    } else {
+        textStream << component.value_;
     }
+    return textStream.str();
 }
 
 /**
- * Checks if mpi-datatypes for 2 different point to point calls are equal.
+ * Renders a canonical form independent of the translation unit.
+ * Unordered forms are sorted by portable text, as their canonical
+ * order depends on identifier addresses.
  *
- * @param sendCall
- * @param recvCall
+ * @param canonicalForm
  *
- * @return equality
+ * @return portable text
  */
-bool MPICheckerAST::areDatatypesEqual(const MPICall &sendCall,
-                                      const MPICall &recvCall) const {
-    // compare mpi datatype
-    llvm::StringRef sendDataType = util::sourceRangeAsStringRef(
-        sendCall.arguments()[MPIPointToPoint::kDatatype]
-            .stmt_->getSourceRange(),
-        analysisManager_);
+std::string portableText(const CanonicalForm *const canonicalForm) {
+    std::vector<std::string> components;
+    for (const StatementComponent &component : canonicalForm->components()) {
+        components.push_back(portableText(component));
+    }
+    if (!canonicalForm->isOrdered()) cont::sort(components);
 
-    llvm::StringRef recvDataType = util::sourceRangeAsStringRef(
-        recvCall.arguments()[MPIPointToPoint::kDatatype]
-            .stmt_->getSourceRange(),
-        analysisManager_);
+    std::string text{canonicalForm->isOrdered() ? "o" : "p"};
+    for (const std::string &component : components) {
+        text += ',' + component;
+    }
+    return text;
+}
+
+}  // end of anonymous namespace
 
-    return sendDataType == recvDataType;
+/**
+ * Renders the match key of a call independent of the translation unit.
+ *
+ * @param mpiCall
+ *
+ * @return portable match key, empty if the call can not be matched
+ */
+std::string MPICheckerAST::portableMatchKey(const MPICall &mpiCall) const {
+    const MatchKey &key = matchKey(mpiCall);
+    if (!key.isValid()) return "";
+
+    const char separator{'\x1f'};
+    const std::string datatype{
+        key.derivedDatatype_ ? portableText(key.derivedDatatype_)
+                             : datatypeName(key.datatype_).str()};
+    return datatype + separator + portableText(key.count_) +
+           separator + portableText(key.tag_) + separator +
+           portableText(key.rankTail_) + separator +
+           portableText(key.rankLastOperand_) + separator +
+           (key.isAddition_ ? '+' : '-');
 }
 
 /**
- * Check if two calls are a send/recv pair.
+ * Returns the presumed location of a call as file:line:column.
  *
- * @param sendCall
- * @param recvCall
+ * @param callExpr
  *
- * @return if they are send/recv pair
+ * @return location
  */
-bool MPICheckerAST::isSendRecvPair(const MPICall &sendCall,
-                                   const MPICall &recvCall) const {
-    if (!funcClassifier_.isSendType(sendCall)) return false;
-    if (!funcClassifier_.isRecvType(recvCall)) return false;
-    if (!areDatatypesEqual(sendCall, recvCall)) return false;
+std::string MPICheckerAST::location(const CallExpr *const callExpr) const {
+    const SourceManager &sourceManager = analysisManager_.getSourceManager();
+    const PresumedLoc presumedLoc = sourceManager.getPresumedLoc(
+        sourceManager.getExpansionLoc(callExpr->getLocStart()));
+    if (presumedLoc.isInvalid()) return "";
+
+    return std::string{presumedLoc.getFilename()} + ':' +
+           std::to_string(presumedLoc.getLine()) + ':' +
+           std::to_string(presumedLoc.getColumn());
+}
 
-    // compare count, tag
-    for (const size_t idx : {MPIPointToPoint::kCount, MPIPointToPoint::kTag}) {
-        if (!sendCall.arguments()[idx].isEqual(recvCall.arguments()[idx])) {
-            return false;
+/**
+ * Summarizes the rank cases of the translation unit, so that the point to
+ * point schema can be checked across translation units.
+ *
+ * @return summary
+ */
+MPISummary MPICheckerAST::summary() const {
+    MPISummary summary;
+    for (const MPIRankCase *rankCase : analysisContext_.rankCases()) {
+        SummaryRankCase summaryCase;
+        summaryCase.isAmbiguous_ = rankCase->isConditionAmbiguous();
+        if (!summaryCase.isAmbiguous_) {
+            summaryCase.condition_ =
+                portableText(rankCase->matchedCondition()->canonicalForm());
         }
-    }
-
-    // compare ranks
-    const auto &rankArgSend = sendCall.arguments()[MPIPointToPoint::kRank];
-    const auto &rankArgRecv = recvCall.arguments()[MPIPointToPoint::kRank];
-
-    if (rankArgSend.typeSequence().size() != rankArgRecv.typeSequence().size())
-        return false;
 
-    // build sequences without last operator(skip first element)
-    std::vector<ArgumentVisitor::ComponentType> seq1, seq2;
-    std::vector<std::string> val1, val2;
-    bool containsSubtraction{false};
-    for (size_t i = 1; i < rankArgSend.typeSequence().size(); ++i) {
-        seq1.push_back(rankArgSend.typeSequence()[i]);
-        val1.push_back(rankArgSend.valueSequence()[i]);
-        seq2.push_back(rankArgRecv.typeSequence()[i]);
-        val2.push_back(rankArgRecv.valueSequence()[i]);
-        if (rankArgSend.valueSequence()[i] == "-") containsSubtraction = true;
-        if (rankArgRecv.valueSequence()[i] == "-") containsSubtraction = true;
-    }
-
-    if (containsSubtraction) {
-        // check ordered
-        if (seq1 != seq2 || val1 != val2) return false;
-    } else {
-        // check permutation
-        if ((!cont::isPermutation(seq1, seq2)) ||
-            (!cont::isPermutation(val1, val2))) {
-            return false;
+        for (const RankCaseCall &call : rankCase->mpiCalls()) {
+            summaryCase.calls_.push_back(
+                {call.mpiCall_->identInfo()->getName().str(),
+                 location(call.callExpr()),
+                 portableMatchKey(*call.mpiCall_),
+                 funcClassifier_.isSendType(call),
+                 funcClassifier_.isRecvType(call),
+                 funcClassifier_.isBlockingType(call)});
         }
+        summary.rankCases_.push_back(std::move(summaryCase));
     }
-    // last (value|var|function) must be identical
-    if (val1.back() != val2.back()) return false;
-
-    // last operator must be inverse
-    if (!rankArgSend.isLastOperatorInverse(rankArgRecv)) return false;
-
-    return true;
+    return summary;
 }
 
 /**
@@ -264,17 +348,17 @@ void MPICheckerAST::checkBufferTypeMatch(const MPICall &mpiCall) const {
     // check if their types match
     for (const auto &idxPair : indexPairs) {
         const VarDecl *bufferArg =
-            mpiCall.arguments()[idxPair.first].vars().front();
+            mpiCall.argument(idxPair.first).vars().front();
 
-        // collect buffer type information
-        const mpi::TypeVisitor typeVisitor{bufferArg->getType()};
+        // buffer type information
+        const TypeClass typeClass = typeClasses_.classify(bufferArg->getType());
 
-        // get mpi datatype as string
-        auto mpiDatatype = mpiCall.arguments()[idxPair.second].stmt_;
-        StringRef mpiDatatypeString{util::sourceRangeAsStringRef(
-            mpiDatatype->getSourceRange(), analysisManager_)};
+        // derived datatypes are not checked
+        const MPIDatatype mpiDatatype{
+            datatypes_.resolve(mpiCall.callExpr()->getArg(idxPair.second))};
+        if (mpiDatatype == MPIDatatype::kUnknown) continue;
 
-        selectTypeMatcher(typeVisitor, mpiCall, mpiDatatypeString, idxPair);
+        selectTypeMatcher(typeClass, mpiCall, mpiDatatype, idxPair);
     }
 }
 
@@ -295,9 +379,7 @@ MPICheckerAST::IndexPairs MPICheckerAST::bufferDataTypeIndices(
     } else if (funcClassifier_.isCollectiveType(mpiCall)) {
         if (funcClassifier_.isReduceType(mpiCall)) {
             // only check buffer type if not inplace
-            if (util::sourceRangeAsStringRef(
-                    mpiCall.callExpr()->getArg(0)->getSourceRange(),
-                    analysisManager_) != "MPI_IN_PLACE") {
+            if (!datatypes_.isInPlace(mpiCall.callExpr()->getArg(0))) {
                 indexPairs.push_back({0, 3});
             }
             indexPairs.push_back({1, 3});
@@ -317,73 +399,73 @@ MPICheckerAST::IndexPairs MPICheckerAST::bufferDataTypeIndices(
  * Select apprioriate function to match the buffer type against
  * the specified mpi datatype.
  *
- * @param typeVisitor contains information about the buffer
+ * @param typeClass classification of the buffer type
  * @param mpiCall call whose arguments are observed
- * @param mpiDatatypeString
+ * @param mpiDatatype
  * @param idxPair bufferIdx, mpiDatatypeIdx
  */
 void MPICheckerAST::selectTypeMatcher(
-    const mpi::TypeVisitor &typeVisitor, const MPICall &mpiCall,
-    const StringRef mpiDatatypeString,
+    const TypeClass &typeClass, const MPICall &mpiCall,
+    const MPIDatatype mpiDatatype,
     const std::pair<size_t, size_t> &idxPair) const {
-    const clang::BuiltinType *builtinTypeBuffer = typeVisitor.builtinType();
+    const clang::BuiltinType *builtinTypeBuffer = typeClass.builtinType_;
     bool isTypeMatching{true};
 
     // check for exact width types (e.g. int16_t, uint32_t)
-    if (typeVisitor.isTypedefType()) {
-        isTypeMatching = matchExactWidthType(typeVisitor, mpiDatatypeString);
+    if (typeClass.isTypedef_) {
+        isTypeMatching = matchExactWidthType(typeClass, mpiDatatype);
     }
     // check for complex-floating types (e.g. float _Complex)
-    else if (typeVisitor.complexType()) {
-        isTypeMatching = matchComplexType(typeVisitor, mpiDatatypeString);
+    else if (typeClass.isComplex_) {
+        isTypeMatching = matchComplexType(typeClass, mpiDatatype);
     }
     // check for basic builtin types (e.g. int, char)
     else if (!builtinTypeBuffer)
         return;  // if no builtin type cancel checking
     else if (builtinTypeBuffer->isBooleanType()) {
-        isTypeMatching = matchBoolType(typeVisitor, mpiDatatypeString);
+        isTypeMatching = matchBoolType(typeClass, mpiDatatype);
     } else if (builtinTypeBuffer->isAnyCharacterType()) {
-        isTypeMatching = matchCharType(typeVisitor, mpiDatatypeString);
+        isTypeMatching = matchCharType(typeClass, mpiDatatype);
     } else if (builtinTypeBuffer->isSignedInteger()) {
-        isTypeMatching = matchSignedType(typeVisitor, mpiDatatypeString);
+        isTypeMatching = matchSignedType(typeClass, mpiDatatype);
     } else if (builtinTypeBuffer->isUnsignedIntegerType()) {
-        isTypeMatching = matchUnsignedType(typeVisitor, mpiDatatypeString);
+        isTypeMatching = matchUnsignedType(typeClass, mpiDatatype);
     } else if (builtinTypeBuffer->isFloatingType()) {
-        isTypeMatching = matchFloatType(typeVisitor, mpiDatatypeString);
+        isTypeMatching = matchFloatType(typeClass, mpiDatatype);
     }
 
     if (!isTypeMatching)
         bugReporter_.reportTypeMismatch(mpiCall.callExpr(), idxPair);
 }
 
-bool MPICheckerAST::matchBoolType(const mpi::TypeVisitor &visitor,
-                                  const llvm::StringRef mpiDatatype) const {
-    return (mpiDatatype == "MPI_C_BOOL");
+bool MPICheckerAST::matchBoolType(const TypeClass &typeClass,
+                                  const MPIDatatype mpiDatatype) const {
+    return (mpiDatatype == MPIDatatype::kCBool);
 }
 
-bool MPICheckerAST::matchCharType(const mpi::TypeVisitor &visitor,
-                                  const llvm::StringRef mpiDatatype) const {
+bool MPICheckerAST::matchCharType(const TypeClass &typeClass,
+                                  const MPIDatatype mpiDatatype) const {
     bool isTypeMatching;
-    switch (visitor.builtinType()->getKind()) {
+    switch (typeClass.builtinType_->getKind()) {
         case BuiltinType::SChar:
-            isTypeMatching =
-                (mpiDatatype == "MPI_CHAR" || mpiDatatype == "MPI_SIGNED_CHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kChar ||
+                              mpiDatatype == MPIDatatype::kSignedChar);
             break;
         case BuiltinType::Char_S:
-            isTypeMatching =
-                (mpiDatatype == "MPI_CHAR" || mpiDatatype == "MPI_SIGNED_CHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kChar ||
+                              mpiDatatype == MPIDatatype::kSignedChar);
             break;
         case BuiltinType::UChar:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED_CHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsignedChar);
             break;
         case BuiltinType::Char_U:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED_CHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsignedChar);
             break;
         case BuiltinType::WChar_S:
-            isTypeMatching = (mpiDatatype == "MPI_WCHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kWChar);
             break;
         case BuiltinType::WChar_U:
-            isTypeMatching = (mpiDatatype == "MPI_WCHAR");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kWChar);
             break;
 
         default:
@@ -393,23 +475,22 @@ bool MPICheckerAST::matchCharType(const mpi::TypeVisitor &visitor,
     return isTypeMatching;
 }
 
-bool MPICheckerAST::matchSignedType(const mpi::TypeVisitor &visitor,
-                                    const llvm::StringRef mpiDatatype) const {
+bool MPICheckerAST::matchSignedType(const TypeClass &typeClass,
+                                    const MPIDatatype mpiDatatype) const {
     bool isTypeMatching;
 
-    switch (visitor.builtinType()->getKind()) {
+    switch (typeClass.builtinType_->getKind()) {
         case BuiltinType::Int:
-            isTypeMatching = (mpiDatatype == "MPI_INT");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kInt);
             break;
         case BuiltinType::Long:
-            isTypeMatching = (mpiDatatype == "MPI_LONG");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kLong);
             break;
         case BuiltinType::Short:
-            isTypeMatching = (mpiDatatype == "MPI_SHORT");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kShort);
             break;
         case BuiltinType::LongLong:
-            isTypeMatching = (mpiDatatype == "MPI_LONG_LONG" ||
-                              mpiDatatype == "MPI_LONG_LONG_INT");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kLongLong);
             break;
         default:
             isTypeMatching = true;
@@ -418,22 +499,22 @@ bool MPICheckerAST::matchSignedType(const mpi::TypeVisitor &visitor,
     return isTypeMatching;
 }
 
-bool MPICheckerAST::matchUnsignedType(const mpi::TypeVisitor &visitor,
-                                      const llvm::StringRef mpiDatatype) const {
+bool MPICheckerAST::matchUnsignedType(const TypeClass &typeClass,
+                                      const MPIDatatype mpiDatatype) const {
     bool isTypeMatching;
 
-    switch (visitor.builtinType()->getKind()) {
+    switch (typeClass.builtinType_->getKind()) {
         case BuiltinType::UInt:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsigned);
             break;
         case BuiltinType::UShort:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED_SHORT");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsignedShort);
             break;
         case BuiltinType::ULong:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED_LONG");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsignedLong);
             break;
         case BuiltinType::ULongLong:
-            isTypeMatching = (mpiDatatype == "MPI_UNSIGNED_LONG_LONG");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kUnsignedLongLong);
             break;
 
         default:
@@ -442,19 +523,19 @@ bool MPICheckerAST::matchUnsignedType(const mpi::TypeVisitor &visitor,
     return isTypeMatching;
 }
 
-bool MPICheckerAST::matchFloatType(const mpi::TypeVisitor &visitor,
-                                   const llvm::StringRef mpiDatatype) const {
+bool MPICheckerAST::matchFloatType(const TypeClass &typeClass,
+                                   const MPIDatatype mpiDatatype) const {
     bool isTypeMatching;
 
-    switch (visitor.builtinType()->getKind()) {
+    switch (typeClass.builtinType_->getKind()) {
         case BuiltinType::Float:
-            isTypeMatching = (mpiDatatype == "MPI_FLOAT");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kFloat);
             break;
         case BuiltinType::Double:
-            isTypeMatching = (mpiDatatype == "MPI_DOUBLE");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kDouble);
             break;
         case BuiltinType::LongDouble:
-            isTypeMatching = (mpiDatatype == "MPI_LONG_DOUBLE");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kLongDouble);
             break;
         default:
             isTypeMatching = true;
@@ -462,20 +543,19 @@ bool MPICheckerAST::matchFloatType(const mpi::TypeVisitor &visitor,
     return isTypeMatching;
 }
 
-bool MPICheckerAST::matchComplexType(const mpi::TypeVisitor &visitor,
-                                     const llvm::StringRef mpiDatatype) const {
+bool MPICheckerAST::matchComplexType(const TypeClass &typeClass,
+                                     const MPIDatatype mpiDatatype) const {
     bool isTypeMatching;
 
-    switch (visitor.builtinType()->getKind()) {
+    switch (typeClass.builtinType_->getKind()) {
         case BuiltinType::Float:
-            isTypeMatching = (mpiDatatype == "MPI_C_COMPLEX" ||
-                              mpiDatatype == "MPI_C_FLOAT_COMPLEX");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kCFloatComplex);
             break;
         case BuiltinType::Double:
-            isTypeMatching = (mpiDatatype == "MPI_C_DOUBLE_COMPLEX");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kCDoubleComplex);
             break;
         case BuiltinType::LongDouble:
-            isTypeMatching = (mpiDatatype == "MPI_C_LONG_DOUBLE_COMPLEX");
+            isTypeMatching = (mpiDatatype == MPIDatatype::kCLongDoubleComplex);
             break;
         default:
             isTypeMatching = true;
@@ -485,21 +565,11 @@ bool MPICheckerAST::matchComplexType(const mpi::TypeVisitor &visitor,
 }
 
 bool MPICheckerAST::matchExactWidthType(
-    const mpi::TypeVisitor &visitor, const llvm::StringRef mpiDatatype) const {
-    // check typedef type match
-    // no break needs to be specified for string switch
-    bool isTypeMatching = llvm::StringSwitch<bool>(visitor.typedefTypeName())
-                              .Case("int8_t", (mpiDatatype == "MPI_INT8_T"))
-                              .Case("int16_t", (mpiDatatype == "MPI_INT16_T"))
-                              .Case("int32_t", (mpiDatatype == "MPI_INT32_T"))
-                              .Case("int64_t", (mpiDatatype == "MPI_INT64_T"))
-
-                              .Case("uint8_t", (mpiDatatype == "MPI_UINT8_T"))
-                              .Case("uint16_t", (mpiDatatype == "MPI_UINT16_T"))
-                              .Case("uint32_t", (mpiDatatype == "MPI_UINT32_T"))
-                              .Case("uint64_t", (mpiDatatype == "MPI_UINT64_T"))
-                              // unknown typedefs are rated as correct
-                              .Default(true);
+    const TypeClass &typeClass, const MPIDatatype mpiDatatype) const {
+    // unknown typedefs are rated as correct
+    const bool isTypeMatching =
+        typeClass.exactWidthDatatype_ == MPIDatatype::kUnknown ||
+        typeClass.exactWidthDatatype_ == mpiDatatype;
 
     return isTypeMatching;
 }
@@ -518,12 +588,12 @@ void MPICheckerAST::checkForInvalidArgs(const MPICall &mpiCall) const {
     // iterate indices which should not have integer arguments
     for (const size_t idx : indicesToCheck) {
         // check for invalid variable types
-        const auto &arg = mpiCall.arguments()[idx];
+        const auto &arg = mpiCall.argument(idx);
         const auto &vars = arg.vars();
         for (const auto &var : vars) {
-            const mpi::TypeVisitor typeVisitor{var->getType()};
-            if (!typeVisitor.builtinType() ||
-                !typeVisitor.builtinType()->isIntegerType()) {
+            const BuiltinType *builtinType =
+                typeClasses_.classify(var->getType()).builtinType_;
+            if (!builtinType || !builtinType->isIntegerType()) {
                 bugReporter_.reportInvalidArgumentType(
                     mpiCall.callExpr(), idx, var->getSourceRange(), "Variable");
             }
@@ -539,9 +609,9 @@ void MPICheckerAST::checkForInvalidArgs(const MPICall &mpiCall) const {
         // check for invalid return types from functions
         const auto &functions = arg.functions();
         for (const auto &function : functions) {
-            const mpi::TypeVisitor typeVisitor{function->getReturnType()};
-            if (!typeVisitor.builtinType() ||
-                !typeVisitor.builtinType()->isIntegerType()) {
+            const BuiltinType *builtinType =
+                typeClasses_.classify(function->getReturnType()).builtinType_;
+            if (!builtinType || !builtinType->isIntegerType()) {
                 bugReporter_.reportInvalidArgumentType(
                     mpiCall.callExpr(), idx, function->getSourceRange(),
                     "Return value");
@@ -596,11 +666,11 @@ std::vector<size_t> MPICheckerAST::integerIndices(
  * @return is equal call in list
  */
 void MPICheckerAST::checkForRedundantCalls() const {
-    MPIRankCase::unmarkCalls();
+    analysisContext_.unmarkCalls();
 
-    for (MPIRankCase &rankCase : MPIRankCase::visitedRankCases) {
-        for (const MPICall &callToCheck : rankCase.mpiCalls()) {
-            checkForRedundantCall(callToCheck, rankCase);
+    for (MPIRankCase *rankCase : analysisContext_.rankCases()) {
+        for (RankCaseCall &callToCheck : rankCase->mpiCalls()) {
+            checkForRedundantCall(callToCheck, *rankCase);
         }
     }
 }
@@ -610,11 +680,11 @@ void MPICheckerAST::checkForRedundantCalls() const {
  *
  * @param callToCheck
  */
-void MPICheckerAST::checkForRedundantCall(const MPICall &callToCheck,
+void MPICheckerAST::checkForRedundantCall(RankCaseCall &callToCheck,
                                           const MPIRankCase &rankCase) const {
-    for (const MPICall &comparedCall : rankCase.mpiCalls()) {
+    for (const RankCaseCall &comparedCall : rankCase.mpiCalls()) {
         if (qualifyRedundancyCheck(callToCheck, comparedCall)) {
-            if (callToCheck == comparedCall) {
+            if (*callToCheck.mpiCall_ == *comparedCall.mpiCall_) {
                 bugReporter_.reportRedundantCall(callToCheck.callExpr(),
                                                  comparedCall.callExpr());
                 callToCheck.isMarked_ = true;
@@ -633,11 +703,13 @@ void MPICheckerAST::checkForRedundantCall(const MPICall &callToCheck,
  *
  * @return
  */
-bool MPICheckerAST::qualifyRedundancyCheck(const MPICall &callToCheck,
-                                           const MPICall &comparedCall) const {
+bool MPICheckerAST::qualifyRedundancyCheck(
+    const RankCaseCall &callToCheck, const RankCaseCall &comparedCall) const {
     if (comparedCall.isMarked_) return false;  // to omit double matching
     // do not compare with the call itself
-    if (callToCheck.id() == comparedCall.id()) return false;
+    if (callToCheck.mpiCall_->id() == comparedCall.mpiCall_->id()) {
+        return false;
+    }
     if (!((funcClassifier_.isPointToPointType(callToCheck) &&
            funcClassifier_.isPointToPointType(comparedCall)) ||
           (funcClassifier_.isCollectiveType(callToCheck) &&
@@ -26,11 +26,12 @@
 #define MPICHECKERAST_HPP_O1KSUWZO
 
 #include "../../ClangSACheckers.h"
-#include "MPIFunctionClassifier.hpp"
-#include "MPIBugReporter.hpp"
+#include "MPISharedContext.hpp"
+#include "MPIAnalysisContext.hpp"
+#include "MPISummary.hpp"
 #include "Container.hpp"
-#include "Utility.hpp"
 #include "TypeVisitor.hpp"
+#include <unordered_map>
 
 namespace mpi {
 
@@ -41,14 +42,23 @@ class MPICheckerAST : public clang::RecursiveASTVisitor<MPICheckerAST> {
 public:
     MPICheckerAST(clang::ento::BugReporter &bugReporter,
                   const clang::ento::CheckerBase &checkerBase,
-                  clang::ento::AnalysisManager &analysisManager)
-        : funcClassifier_{analysisManager},
-          bugReporter_{bugReporter, checkerBase, analysisManager},
-          analysisManager_{analysisManager} {}
+                  clang::ento::AnalysisManager &analysisManager,
+                  MPISharedContext &sharedContext,
+                  MPIAnalysisContext &analysisContext)
+        : funcClassifier_{sharedContext.funcClassifier()},
+          datatypes_{sharedContext.datatypes()},
+          typeClasses_{sharedContext.typeClasses()},
+          canonicalForms_{sharedContext.canonicalForms()},
+          bugReporter_{bugReporter, checkerBase, analysisManager,
+                       sharedContext.bugTypes(), sharedContext.statistics()},
+          statistics_{sharedContext.statistics()},
+          analysisManager_{analysisManager},
+          analysisContext_{analysisContext} {}
 
     void checkPointToPointSchema() const;
     void checkReachbility() const;
     void checkForRedundantCalls() const;
+    MPISummary summary() const;
     void checkForCollectiveCalls(const MPIRankCase &) const;
     void checkForInvalidArgs(const MPICall &) const;
     void checkBufferTypeMatch(const MPICall &mpiCall) const;
@@ -61,30 +71,60 @@ public:
     const MPIFunctionClassifier &funcClassifier() { return funcClassifier_; }
 
 private:
-    bool isSendRecvPair(const MPICall &, const MPICall &) const;
-    bool areDatatypesEqual(const MPICall &, const MPICall &) const;
+    // properties a send and recv call must share to be a pair
+    struct MatchKey {
+        bool isValid() const { return rankTail_ != nullptr; }
+        bool operator==(const MatchKey &) const;
+
+        MPIDatatype datatype_;
+        // argument compared instead if the datatype is not predefined
+        const CanonicalForm *derivedDatatype_;
+        const CanonicalForm *count_;
+        const CanonicalForm *tag_;
+        // rank without its last operator
+        const CanonicalForm *rankTail_;
+        StatementComponent rankLastOperand_;
+        // last rank operator, inverted for receives
+        bool isAddition_;
+    };
+    struct MatchKeyHash {
+        size_t operator()(const MatchKey &) const;
+    };
+    // rank cases of the translation unit as seen by PointToPointMatcher
+    class RankCaseSchema;
+
+    const MatchKey &matchKey(const MPICall &) const;
+    MatchKey buildMatchKey(const MPICall &) const;
+    std::string portableMatchKey(const MPICall &) const;
+    std::string location(const clang::CallExpr *const) const;
     void checkUnmatchedCalls() const;
-    void checkSendRecvMatches(const MPIRankCase &, const MPIRankCase &) const;
-    void checkReachbilityPair(const MPIRankCase &, const MPIRankCase &) const;
-    void checkForRedundantCall(const MPICall &callToCheck,
+    void checkForRedundantCall(RankCaseCall &callToCheck,
                                const MPIRankCase &) const;
-    bool qualifyRedundancyCheck(const MPICall &, const MPICall &) const;
+    bool qualifyRedundancyCheck(const RankCaseCall &,
+                                const RankCaseCall &) const;
     std::vector<size_t> integerIndices(const MPICall &) const;
 
-    void selectTypeMatcher(const TypeVisitor &, const MPICall &,
-                           const clang::StringRef,
+    void selectTypeMatcher(const TypeClass &, const MPICall &,
+                           const MPIDatatype,
                            const std::pair<size_t, size_t> &) const;
-    bool matchBoolType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchCharType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchSignedType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchUnsignedType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchFloatType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchComplexType(const TypeVisitor &, const llvm::StringRef) const;
-    bool matchExactWidthType(const TypeVisitor &, const llvm::StringRef) const;
-
-    MPIFunctionClassifier funcClassifier_;
+    bool matchBoolType(const TypeClass &, const MPIDatatype) const;
+    bool matchCharType(const TypeClass &, const MPIDatatype) const;
+    bool matchSignedType(const TypeClass &, const MPIDatatype) const;
+    bool matchUnsignedType(const TypeClass &, const MPIDatatype) const;
+    bool matchFloatType(const TypeClass &, const MPIDatatype) const;
+    bool matchComplexType(const TypeClass &, const MPIDatatype) const;
+    bool matchExactWidthType(const TypeClass &, const MPIDatatype) const;
+
+    const MPIFunctionClassifier &funcClassifier_;
+    const MPIDatatypeResolver &datatypes_;
+    TypeClassCache &typeClasses_;
+    CanonicalFormTable &canonicalForms_;
     MPIBugReporter bugReporter_;
+    MPIStatistics &statistics_;
     clang::ento::AnalysisManager &analysisManager_;
+    MPIAnalysisContext &analysisContext_;
+    // point to point match keys by call
+    mutable std::unordered_map<const clang::CallExpr *, MatchKey> matchKeys_;
 };
 
 }  // end of namespace: mpi
@@ -21,18 +21,501 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
 */
-
 #include "MPICheckerPathSensitive.hpp"
-#include "ArrayVisitor.hpp"
+#include <climits>
 
 namespace mpi {
 
 using namespace clang;
 using namespace ento;
 
+namespace {
+
+// Waits on more requests of an array than this are not tracked per
+// element. Elements of such an array are dropped from the state instead.
+const uint64_t kMaxTrackedElements{64};
+
+/**
+ * Get region of the request an argument points to, e.g. the variable for
+ * &request or the element for &requests[i]. Request pointers passed to
+ * inlined functions resolve to the region of the caller.
+ *
+ * @param argument request argument
+ * @param ctx
+ *
+ * @return request region, nullptr if unknown
+ */
+const MemRegion *requestRegion(const Expr *const argument,
+                               CheckerContext &ctx) {
+    return ctx.getSVal(argument).getAsRegion();
+}
+
+/**
+ * Get the array a request region is an element of, if the index of the
+ * element is not known. Such requests are only tracked by the summary of
+ * their array.
+ *
+ * @param region request region
+ *
+ * @return array region, nullptr if the region is no element at an
+ * unknown index
+ */
+const MemRegion *summarizedArray(const MemRegion *const region) {
+    const ElementRegion *const element = dyn_cast<ElementRegion>(region);
+    if (!element || element->getIndex().getAs<nonloc::ConcreteInt>()) {
+        return nullptr;
+    }
+    return element->getSuperRegion();
+}
+
+/**
+ * Find the tracked request a region refers to. This is either the region
+ * itself or a tracked region holding the same request handle, as for
+ * MPI_Request requests[2] = {sendReq, recvReq}. A request whose variable
+ * died while its handle was still held by another region is moved to the
+ * region.
+ *
+ * @param state updated if a request is moved
+ * @param region request region
+ *
+ * @return tracked request region, nullptr if there is none
+ */
+const MemRegion *trackedRequest(ProgramStateRef &state,
+                                const MemRegion *const region) {
+    if (state->get<RequestVarMap>(region)) return region;
+
+    const SVal handle = state->getSVal(region);
+    if (!handle.getAsSymbol() && !handle.getAsRegion()) return nullptr;
+    for (const auto &requestVar : state->get<RequestVarMap>()) {
+        if (state->getSVal(requestVar.first) == handle) {
+            return requestVar.first;
+        }
+    }
+
+    const SymbolRef symbol = handle.getAsSymbol();
+    if (!symbol) return nullptr;
+    for (const auto &requestHandle : state->get<RequestHandleMap>()) {
+        if (requestHandle.second != symbol) continue;
+        const RequestVar *const requestVar =
+            state->get<RequestVarMap>(requestHandle.first);
+        if (!requestVar) return nullptr;
+        const RequestState requestState = requestVar->state_;
+        state = state->remove<RequestHandleMap>(requestHandle.first)
+                    ->remove<RequestVarMap>(requestHandle.first)
+                    ->set<RequestVarMap>(region, {region, requestState});
+        return region;
+    }
+    return nullptr;
+}
+
+/**
+ * Drop all tracked elements of an array, used if a wait completes
+ * elements that cannot be determined.
+ *
+ * @param state
+ * @param array array region
+ *
+ * @return state without elements of the array
+ */
+ProgramStateRef forgetElements(ProgramStateRef state,
+                               const MemRegion *const array) {
+    for (const auto &requestVar : state->get<RequestVarMap>()) {
+        const ElementRegion *const element =
+            dyn_cast<ElementRegion>(requestVar.first);
+        if (element && element->getSuperRegion() == array) {
+            state = state->remove<RequestVarMap>(requestVar.first)
+                        ->remove<RequestHandleMap>(requestVar.first);
+        }
+    }
+    return state;
+}
+
+/**
+ * Get the call of a node added by the checker in the pre statement
+ * callback, if the call is passed the request or an element of the
+ * request array.
+ *
+ * @param node
+ * @param region request or request array region
+ * @param checkerTag tag of the nodes added by the checker
+ *
+ * @return call using the region, nullptr if there is none
+ */
+const CallExpr *usingCall(const ExplodedNode *const node,
+                          const MemRegion *const region,
+                          const ProgramPointTag *const checkerTag) {
+    auto preStmt = node->getLocation().getAs<PreStmt>();
+    if (!preStmt || preStmt->getTag() != checkerTag) return nullptr;
+    const CallExpr *const callExpr = dyn_cast<CallExpr>(preStmt->getStmt());
+    if (!callExpr) return nullptr;
+
+    for (unsigned i = 0; i < callExpr->getNumArgs(); ++i) {
+        const MemRegion *const argRegion =
+            node->getState()
+                ->getSVal(callExpr->getArg(i), node->getLocationContext())
+                .getAsRegion();
+        if (!argRegion) continue;
+        const ElementRegion *const element = dyn_cast<ElementRegion>(argRegion);
+        if (argRegion == region ||
+            (element && element->getSuperRegion() == region)) {
+            return callExpr;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Recovers the call that left a request or request array in its current
+ * state. The exploded graph is walked back to the most recent call
+ * accepted by isUser the checker added a node for. Requests used through
+ * a copy of their handle are not passed to that call, for these the walk
+ * ends at the node where the state was set. Array summaries are also
+ * changed by calls not posting into the array, like MPI_Waitany, so the
+ * walk only falls back to that node if no post is found.
+ *
+ * @param node node whose state contains the request
+ * @param region request or request array region
+ * @param checkerTag tag of the nodes added by the checker
+ * @param isUser predicate for calls setting the current state
+ * @param stopAtChange end the walk at the node where the state was set
+ *
+ * @return call that last used the request
+ */
+template <typename RequestMap, typename IsUser>
+const CallExpr *lastUser(const ExplodedNode *node,
+                         const MemRegion *const region,
+                         const ProgramPointTag *const checkerTag,
+                         IsUser isUser, const bool stopAtChange) {
+    const auto value = node->getState()->get<RequestMap>(region);
+    if (!value) return nullptr;
+
+    const ExplodedNode *changed = nullptr;
+    for (; node; node = node->getFirstPred()) {
+        const CallExpr *const callExpr = usingCall(node, region, checkerTag);
+        if (callExpr && isUser(callExpr)) return callExpr;
+        if (changed) continue;
+
+        const ExplodedNode *const pred = node->getFirstPred();
+        const auto predValue =
+            pred ? pred->getState()->get<RequestMap>(region) : nullptr;
+        if (!predValue || !(*predValue == *value)) {
+            changed = node;
+            if (stopAtChange) break;
+        }
+    }
+
+    // transitions are added in the pre statement callback of the call
+    if (changed) {
+        if (auto stmtPoint = changed->getLocation().getAs<StmtPoint>()) {
+            return dyn_cast<CallExpr>(stmtPoint->getStmt());
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Complete requests of an array summary, e.g. for a wait on an element at
+ * an unknown index.
+ *
+ * @param state
+ * @param array array region
+ * @param count number of requests to complete
+ *
+ * @return state with updated summary
+ */
+ProgramStateRef completeSummary(ProgramStateRef state,
+                                const MemRegion *const array,
+                                const unsigned count) {
+    const RequestArray *const requestArray =
+        state->get<RequestArrayMap>(array);
+    if (!requestArray) return state;
+    return state->set<RequestArrayMap>(array, requestArray->completed(count));
+}
+
+/**
+ * Move the tracked requests of an array into its summary. Used if it is
+ * not known which of the requests a call completes, so that one state
+ * stands for all orders of completion.
+ *
+ * @param state
+ * @param array array region
+ * @param elements enumerated element regions of the array
+ *
+ * @return state with the requests counted by the summary
+ */
+ProgramStateRef summarizeRequests(
+    ProgramStateRef state, const MemRegion *const array,
+    llvm::ArrayRef<const MemRegion *> elements) {
+    unsigned inFlight = 0;
+    for (const MemRegion *element : elements) {
+        const MemRegion *const tracked = trackedRequest(state, element);
+        if (!tracked) continue;
+        if (state->get<RequestVarMap>(tracked)->state_ ==
+            RequestState::kNonblocking) {
+            ++inFlight;
+        }
+        state = state->remove<RequestVarMap>(tracked);
+    }
+    if (!inFlight) return state;
+
+    const RequestArray *const requestArray =
+        state->get<RequestArrayMap>(array);
+    return state->set<RequestArrayMap>(
+        array, requestArray ? requestArray->posted(inFlight)
+                            : RequestArray{}.posted(inFlight));
+}
+
+/**
+ * Get the element regions of the request array argument of a call, which
+ * takes a count as first and the array as second argument.
+ *
+ * @param callExpr
+ * @param ctx
+ * @param array set to the array region, nullptr if unknown
+ * @param elements element regions, the argument points to the first
+ *
+ * @return true if the elements could be enumerated
+ */
+bool arrayElements(const CallExpr *const callExpr, CheckerContext &ctx,
+                   const MemRegion *&array,
+                   llvm::SmallVectorImpl<const MemRegion *> &elements) {
+    const Expr *const arrayArg = callExpr->getArg(1);
+    array = requestRegion(arrayArg, ctx);
+    if (!array) return false;
+
+    QualType elementType = arrayArg->getType()->getPointeeType();
+    Optional<nonloc::ConcreteInt> offset;
+    if (const ElementRegion *element = dyn_cast<ElementRegion>(array)) {
+        array = element->getSuperRegion();
+        elementType = element->getElementType();
+        offset = element->getIndex().getAs<nonloc::ConcreteInt>();
+        if (!offset) return false;
+    }
+
+    auto count = ctx.getSVal(callExpr->getArg(0)).getAs<nonloc::ConcreteInt>();
+    if (!count || count->getValue().getLimitedValue() > kMaxTrackedElements) {
+        return false;
+    }
+    const uint64_t first = offset ? offset->getValue().getLimitedValue() : 0;
+    MemRegionManager &regionManager = ctx.getStoreManager().getRegionManager();
+    for (uint64_t i = 0; i < count->getValue().getLimitedValue(); ++i) {
+        elements.push_back(regionManager.getElementRegion(
+            elementType, ctx.getSValBuilder().makeArrayIndex(first + i), array,
+            ctx.getASTContext()));
+    }
+    return true;
+}
+
+// misuse found while completing requests by a wait
+struct WaitReports {
+    llvm::SmallVector<const MemRegion *, 1> unmatchedWaits_;
+    llvm::SmallVector<const MemRegion *, 1> doubleWaits_;
+};
+
+/**
+ * Complete requests referred to by regions. Waits collect reports and
+ * complete requests in any state. Other calls only complete requests in
+ * use by a nonblocking call, untracked requests are ignored.
+ *
+ * @param state
+ * @param regions request regions
+ * @param completedState state the requests are left in
+ * @param reports reports of a wait, nullptr for other calls
+ *
+ * @return state with completed requests
+ */
+ProgramStateRef completeRequests(ProgramStateRef state,
+                                 llvm::ArrayRef<const MemRegion *> regions,
+                                 const RequestState completedState,
+                                 WaitReports *const reports) {
+    for (const MemRegion *region : regions) {
+        const MemRegion *const tracked = trackedRequest(state, region);
+
+        // no matching nonblocking call, unless posted at an unknown index
+        if (!tracked) {
+            const ElementRegion *const element =
+                dyn_cast<ElementRegion>(region);
+            const bool isSummarized =
+                element && state->get<RequestArrayMap>(
+                               element->getSuperRegion());
+            // the summary is completed, elements are not tracked by it
+            if (isSummarized) {
+                state = completeSummary(state, element->getSuperRegion(), 1);
+            } else if (reports) {
+                state = state->set<RequestVarMap>(region,
+                                                  {region, completedState});
+                reports->unmatchedWaits_.push_back(region);
+            }
+            continue;
+        }
+
+        switch (state->get<RequestVarMap>(tracked)->state_) {
+            case RequestState::kNonblocking:
+                break;
+            case RequestState::kWaited:
+                if (!reports) continue;
+                reports->doubleWaits_.push_back(tracked);
+                break;
+            case RequestState::kCompleted:
+            case RequestState::kFreed:
+                if (!reports) continue;
+                break;
+        }
+        state = state->set<RequestVarMap>(tracked, {tracked, completedState});
+    }
+    return state;
+}
+
+/**
+ * Model the effect of a completion call on the requests it refers to.
+ * Calls completing one request of an array without telling which, move
+ * the requests of the array into its summary instead of exploring one
+ * state per request.
+ *
+ * @param callExpr
+ * @param ctx
+ * @param funcClassifier
+ * @param completedState state completed requests are left in
+ * @param reports reports of a wait, nullptr for other calls
+ *
+ * @return state after the call
+ */
+ProgramStateRef complete(const CallExpr *const callExpr, CheckerContext &ctx,
+                         const MPIFunctionClassifier &funcClassifier,
+                         const RequestState completedState,
+                         WaitReports *const reports) {
+    const IdentifierInfo *const identInfo =
+        callExpr->getDirectCallee()->getIdentifier();
+    ProgramStateRef state = ctx.getState();
+
+    llvm::SmallVector<const MemRegion *, 2> requestRegions;
+    if (funcClassifier.isMPI_Wait(identInfo) ||
+        funcClassifier.isMPI_Test(identInfo) ||
+        funcClassifier.isMPI_Request_free(identInfo)) {
+        const MemRegion *const region =
+            requestRegion(callExpr->getArg(0), ctx);
+        if (!region) return state;
+
+        if (const MemRegion *const array = summarizedArray(region)) {
+            return state->get<RequestArrayMap>(array)
+                       ? completeSummary(state, array, 1)
+                       : forgetElements(state, array);
+        }
+        requestRegions.push_back(region);
+    } else {
+        const MemRegion *array = nullptr;
+        const bool isEnumerated =
+            arrayElements(callExpr, ctx, array, requestRegions);
+        if (!array) return state;
+        if (!isEnumerated) state = forgetElements(state, array);
+
+        // exactly one request completes
+        if (funcClassifier.isMPI_Waitany(identInfo) ||
+            funcClassifier.isMPI_Testany(identInfo)) {
+            return completeSummary(
+                summarizeRequests(state, array, requestRegions), array, 1);
+        }
+        // requests posted at unknown indices are completed as a whole
+        state = completeSummary(state, array, UINT_MAX);
+    }
+
+    return completeRequests(state, requestRegions, completedState, reports);
+}
+
+/**
+ * Get index of the flag argument of a test call.
+ *
+ * @param funcClassifier
+ * @param identInfo
+ *
+ * @return flag argument index
+ */
+unsigned testFlagIndex(const MPIFunctionClassifier &funcClassifier,
+                       const IdentifierInfo *const identInfo) {
+    if (funcClassifier.isMPI_Test(identInfo)) return 1;
+    if (funcClassifier.isMPI_Testall(identInfo)) return 2;
+    return 3;  // MPI_Testany
+}
+}  // end of anonymous namespace
+
+/**
+ * Add a transition to a state changed by the checks, counted for the
+ * statistics.
+ *
+ * @param ctx
+ * @param state
+ *
+ * @return new node, nullptr if the state was already explored
+ */
+ExplodedNode *MPICheckerPathSensitive::transition(
+    CheckerContext &ctx, ProgramStateRef state) const {
+    statistics_.count(MPIStatistics::kStateTransitions);
+    return ctx.addTransition(state);
+}
+
+/**
+ * Add a transition for a call using requests. A node is added even if
+ * the state is unchanged, e.g. for a request posted again, so that the
+ * call can be found as the last user of its requests.
+ *
+ * @param ctx
+ * @param state
+ *
+ * @return new node, nullptr if the state was already explored
+ */
+ExplodedNode *MPICheckerPathSensitive::useTransition(
+    CheckerContext &ctx, ProgramStateRef state) const {
+    statistics_.count(MPIStatistics::kStateTransitions);
+    return ctx.addTransition(state, &checkerBase_);
+}
+
+/**
+ * Get the call that left a request in its current state. Requests in use
+ * by a nonblocking call were set by a nonblocking call, all others by a
+ * wait.
+ *
+ * @param node node whose state contains the request
+ * @param region request region
+ *
+ * @return call that last used the request
+ */
+const CallExpr *MPICheckerPathSensitive::lastRequestUser(
+    const ExplodedNode *const node, const MemRegion *const region) const {
+    const RequestVar *const requestVar =
+        node->getState()->get<RequestVarMap>(region);
+    if (!requestVar) return nullptr;
+    const bool isNonblocking =
+        requestVar->state_ == RequestState::kNonblocking;
+    return lastUser<RequestVarMap>(
+        node, region, &checkerBase_, [&](const CallExpr *callExpr) {
+            const IdentifierInfo *const identInfo =
+                callExpr->getDirectCallee()->getIdentifier();
+            return isNonblocking ? funcClassifier_.isNonBlockingType(identInfo)
+                                 : funcClassifier_.isWaitType(identInfo);
+        }, true);
+}
+
+/**
+ * Get the nonblocking call that last posted into a request array.
+ *
+ * @param node node whose state contains the array summary
+ * @param array request array region
+ *
+ * @return call that last used the array
+ */
+const CallExpr *MPICheckerPathSensitive::lastArrayUser(
+    const ExplodedNode *const node, const MemRegion *const array) const {
+    return lastUser<RequestArrayMap>(
+        node, array, &checkerBase_, [&](const CallExpr *callExpr) {
+            return funcClassifier_.isNonBlockingType(
+                callExpr->getDirectCallee()->getIdentifier());
+        }, false);
+}
+
 /**
  * Checks if a request is used by nonblocking calls multiple times
- * before intermediate wait.
+ * before intermediate wait. Requests at unknown indices of an array are
+ * counted by the summary of the array.
  *
  * @param callExpr
  * @param ctx
@@ -44,23 +527,38 @@ void MPICheckerPathSensitive::checkDoubleNonblocking(
         return;
     }
 
+    const MemRegion *const region =
+        requestRegion(callExpr->getArg(callExpr->getNumArgs() - 1), ctx);
+    if (!region) return;
     ProgramStateRef state = ctx.getState();
-    auto RequestVars = state->get<RequestVarMap>();
 
-    MPICall mpiCall{const_cast<CallExpr *>(callExpr)};
-    auto arg = mpiCall.arguments()[mpiCall.callExpr()->getNumArgs() - 1];
-    auto requestVarDecl = arg.vars().front();
-    const RequestVar *requestVar = state->get<RequestVarMap>(requestVarDecl);
+    if (const MemRegion *const array = summarizedArray(region)) {
+        const RequestArray *const requestArray =
+            state->get<RequestArrayMap>(array);
+        transition(ctx, state->set<RequestArrayMap>(
+                            array, requestArray ? requestArray->posted()
+                                                : RequestArray{}.posted()));
+        return;
+    }
+
+    const RequestVar *requestVar = state->get<RequestVarMap>(region);
     state = state->set<RequestVarMap>(
-        requestVarDecl, {requestVarDecl, const_cast<CallExpr *>(callExpr)});
-    auto node = ctx.addTransition(state);
+        region, {region, RequestState::kNonblocking});
+    auto node = useTransition(ctx, state);
 
-    if (requestVar && requestVar->lastUser_) {
-        auto lastUserID =
-            requestVar->lastUser_->getDirectCallee()->getIdentifier();
-        if (funcClassifier_.isNonBlockingType(lastUserID)) {
-            bugReporter_.reportDoubleNonblocking(callExpr, *requestVar, node);
-        }
+    if (!requestVar) return;
+    switch (requestVar->state_) {
+        case RequestState::kNonblocking:
+            if (const CallExpr *previousUser =
+                    lastRequestUser(ctx.getPredecessor(), region)) {
+                bugReporter_.reportDoubleNonblocking(callExpr, region,
+                                                     previousUser, node);
+            }
+            break;
+        case RequestState::kWaited:
+        case RequestState::kCompleted:
+        case RequestState::kFreed:
+            break;
     }
 }
 
@@ -78,45 +576,102 @@ void MPICheckerPathSensitive::checkWaitUsage(const CallExpr *callExpr,
         return;
     }
 
-    ProgramStateRef state = ctx.getState();
-    auto requestVars = state->get<RequestVarMap>();
+    WaitReports reports;
+    const ExplodedNode *const node =
+        useTransition(ctx, complete(callExpr, ctx, funcClassifier_,
+                                    RequestState::kWaited, &reports));
+    if (!node) return;
+    for (const MemRegion *region : reports.unmatchedWaits_) {
+        bugReporter_.reportUnmatchedWait(callExpr, region, node);
+    }
+    for (const MemRegion *region : reports.doubleWaits_) {
+        if (const CallExpr *previousUser =
+                lastRequestUser(ctx.getPredecessor(), region)) {
+            bugReporter_.reportDoubleWait(callExpr, region, previousUser,
+                                          node);
+        }
+    }
+}
 
-    // collect request vars
-    MPICall mpiCall{const_cast<CallExpr *>(callExpr)};
-    llvm::SmallVector<VarDecl *, 1> requestVector;
-    if (funcClassifier_.isMPI_Wait(mpiCall)) {
-        requestVector.push_back(mpiCall.arguments()[0].vars().front());
-    } else if (funcClassifier_.isMPI_Waitall(mpiCall)) {
-        ArrayVisitor arrayVisitor{mpiCall.arguments()[1].vars().front()};
+/**
+ * Models calls completing an unknown subset of their requests without a
+ * flag to branch on, and MPI_Request_free. MPI_Waitany completes one
+ * request of the array summary. MPI_Waitsome and MPI_Testsome are
+ * assumed to complete all of their requests, as they are called until
+ * all requests are done. No state is split.
+ *
+ * @param callExpr
+ * @param ctx
+ */
+void MPICheckerPathSensitive::checkPartialCompletion(
+    const CallExpr *callExpr, CheckerContext &ctx) const {
+    const IdentifierInfo *const identInfo =
+        callExpr->getDirectCallee()->getIdentifier();
+    if (funcClassifier_.isMPI_Request_free(identInfo)) {
+        transition(ctx, complete(callExpr, ctx, funcClassifier_,
+                                 RequestState::kFreed, nullptr));
+    } else if (funcClassifier_.isMPI_Waitany(identInfo) ||
+               funcClassifier_.isMPI_Waitsome(identInfo) ||
+               funcClassifier_.isMPI_Testsome(identInfo)) {
+        transition(ctx, complete(callExpr, ctx, funcClassifier_,
+                                 RequestState::kCompleted, nullptr));
+    }
+}
 
-        for (const auto &requestVar : arrayVisitor.vars()) {
-            requestVector.push_back(requestVar);
-        }
+/**
+ * Splits the state at test calls, which may complete their requests or
+ * not. The state is only split if a request in use by a nonblocking call
+ * would be completed. Each state assumes the flag set by the call to
+ * match its outcome in the post statement callback.
+ *
+ * @param callExpr
+ * @param ctx
+ */
+void MPICheckerPathSensitive::checkTestUsage(const CallExpr *callExpr,
+                                             CheckerContext &ctx) const {
+    if (!funcClassifier_.isTestType(
+            callExpr->getDirectCallee()->getIdentifier())) {
+        return;
     }
 
-    const ExplodedNode *const node = ctx.addTransition();
+    ProgramStateRef state = ctx.getState();
+    ProgramStateRef completedState = complete(
+        callExpr, ctx, funcClassifier_, RequestState::kCompleted, nullptr);
+    if (completedState == state) return;
 
-    for (VarDecl *requestVarDecl : requestVector) {
-        const RequestVar *requestVar =
-            state->get<RequestVarMap>(requestVarDecl);
-        state = state->set<RequestVarMap>(
-            requestVarDecl, {requestVarDecl, const_cast<CallExpr *>(callExpr)});
+    transition(ctx, completedState->set<TestOutcomeMap>(callExpr, true));
+    transition(ctx, state->set<TestOutcomeMap>(callExpr, false));
+}
 
-        if (requestVar && requestVar->lastUser_) {
-            auto lastUserID =
-                requestVar->lastUser_->getDirectCallee()->getIdentifier();
-            // check for double wait
-            if (funcClassifier_.isWaitType(lastUserID)) {
-                bugReporter_.reportDoubleWait(callExpr, *requestVar, node);
+/**
+ * Constrains the flag written by a test call to the outcome assumed by
+ * the state before the call.
+ *
+ * @param callExpr
+ * @param ctx
+ */
+void MPICheckerPathSensitive::checkTestFlag(const CallExpr *callExpr,
+                                            CheckerContext &ctx) const {
+    ProgramStateRef state = ctx.getState();
+    const bool *const outcome = state->get<TestOutcomeMap>(callExpr);
+    if (!outcome) return;
+
+    const bool isCompleted = *outcome;
+    state = state->remove<TestOutcomeMap>(callExpr);
+    const unsigned flagIndex = testFlagIndex(
+        funcClassifier_, callExpr->getDirectCallee()->getIdentifier());
+    if (const MemRegion *flag =
+            ctx.getSVal(callExpr->getArg(flagIndex)).getAsRegion()) {
+        if (auto flagValue =
+                state->getSVal(flag).getAs<DefinedOrUnknownSVal>()) {
+            state = state->assume(*flagValue, isCompleted);
+            if (!state) {
+                ctx.generateSink();
+                return;
             }
         }
-        // no matching nonblocking call
-        else {
-            bugReporter_.reportUnmatchedWait(callExpr, requestVarDecl, node);
-        }
     }
-
-    ctx.addTransition(state);
+    transition(ctx, state);
 }
 
 /**
@@ -126,32 +681,130 @@ void MPICheckerPathSensitive::checkWaitUsage(const CallExpr *callExpr,
  */
 void MPICheckerPathSensitive::checkMissingWaits(CheckerContext &ctx) {
     ProgramStateRef state = ctx.getState();
-    auto requestVars = state->get<RequestVarMap>();
     ExplodedNode *node = ctx.addTransition();
     // at the end of a function immediate calls should be matched with wait
-    for (auto &requestVar : requestVars) {
-        if (requestVar.second.lastUser_ &&
-            funcClassifier_.isNonBlockingType(
-                requestVar.second.lastUser_->getDirectCallee()
-                    ->getIdentifier())) {
-            bugReporter_.reportMissingWait(requestVar.second, node);
+    for (auto &requestVar : state->get<RequestVarMap>()) {
+        if (requestVar.second.state_ != RequestState::kNonblocking) continue;
+        if (const CallExpr *previousUser =
+                lastRequestUser(ctx.getPredecessor(), requestVar.first)) {
+            bugReporter_.reportMissingWait(requestVar.first, previousUser,
+                                           node);
+        }
+    }
+    for (auto &requestArray : state->get<RequestArrayMap>()) {
+        if (!requestArray.second.inFlight_) continue;
+        if (const CallExpr *previousUser =
+                lastArrayUser(ctx.getPredecessor(), requestArray.first)) {
+            bugReporter_.reportMissingWait(requestArray.first, previousUser,
+                                           node);
+        }
+    }
+}
+
+/**
+ * Evicts requests and request arrays that went out of scope or are not
+ * used anymore, reporting those still in use by a nonblocking call. Only
+ * regions on the current stack frame are considered, as liveness of the
+ * others is not known at this point. A request whose region is dead stays
+ * tracked as long as its handle is live, e.g. copied into an array of
+ * requests, until a call uses the copy.
+ *
+ * @param symbolReaper
+ * @param ctx
+ */
+void MPICheckerPathSensitive::checkDeadRequests(SymbolReaper &symbolReaper,
+                                                CheckerContext &ctx) const {
+    ProgramStateRef state = ctx.getState();
+    RequestVarMapTy requestVars = state->get<RequestVarMap>();
+    RequestArrayMapTy requestArrays = state->get<RequestArrayMap>();
+    RequestHandleMapTy requestHandles = state->get<RequestHandleMap>();
+    if (requestVars.isEmpty() && requestArrays.isEmpty()) return;
+
+    const StackFrameContext *const stackFrame =
+        ctx.getLocationContext()->getCurrentStackFrame();
+    auto isDead = [&](const MemRegion *region) {
+        const StackSpaceRegion *const stackSpace =
+            dyn_cast<StackSpaceRegion>(region->getMemorySpace());
+        return stackSpace && stackSpace->getStackFrame() == stackFrame &&
+               !symbolReaper.isLiveRegion(region);
+    };
+    llvm::SmallVector<std::pair<const MemRegion *, const CallExpr *>, 2>
+        missingWaits;
+
+    RequestVarMapTy::Factory &varFactory = state->get_context<RequestVarMap>();
+    RequestHandleMapTy::Factory &handleFactory =
+        state->get_context<RequestHandleMap>();
+    for (auto &requestVar : state->get<RequestVarMap>()) {
+        // the handle of a dead region is recorded, as its binding is gone
+        const SymbolRef *const deadHandle =
+            state->get<RequestHandleMap>(requestVar.first);
+        if (!deadHandle && !isDead(requestVar.first)) continue;
+        const SymbolRef handle =
+            deadHandle ? *deadHandle
+                       : state->getSVal(requestVar.first).getAsSymbol();
+        if (handle && symbolReaper.isLive(handle)) {
+            if (!deadHandle) {
+                requestHandles = handleFactory.add(requestHandles,
+                                                   requestVar.first, handle);
+            }
+            continue;
+        }
+
+        if (requestVar.second.state_ == RequestState::kNonblocking) {
+            missingWaits.push_back(
+                {requestVar.first,
+                 lastRequestUser(ctx.getPredecessor(), requestVar.first)});
+        }
+        requestVars = varFactory.remove(requestVars, requestVar.first);
+        requestHandles = handleFactory.remove(requestHandles, requestVar.first);
+    }
+
+    RequestArrayMapTy::Factory &arrayFactory =
+        state->get_context<RequestArrayMap>();
+    for (auto &requestArray : state->get<RequestArrayMap>()) {
+        if (!isDead(requestArray.first)) continue;
+        if (requestArray.second.inFlight_) {
+            missingWaits.push_back(
+                {requestArray.first,
+                 lastArrayUser(ctx.getPredecessor(), requestArray.first)});
+        }
+        requestArrays = arrayFactory.remove(requestArrays, requestArray.first);
+    }
+
+    if (requestVars == state->get<RequestVarMap>() &&
+        requestArrays == state->get<RequestArrayMap>() &&
+        requestHandles == state->get<RequestHandleMap>()) {
+        return;
+    }
+
+    ExplodedNode *node =
+        transition(ctx, state->set<RequestVarMap>(requestVars)
+                            ->set<RequestArrayMap>(requestArrays)
+                            ->set<RequestHandleMap>(requestHandles));
+    if (!node) return;
+    for (const auto &missingWait : missingWaits) {
+        if (missingWait.second) {
+            bugReporter_.reportMissingWait(missingWait.first,
+                                           missingWait.second, node);
         }
     }
 }
 
 /**
- * Erase all request vars from the path sensitive map.
+ * Erase all requests and request arrays from the path sensitive maps at
+ * once.
  *
  * @param ctx
  */
 void MPICheckerPathSensitive::clearRequestVars(CheckerContext &ctx) const {
     ProgramStateRef state = ctx.getState();
-    auto requestVars = state->get<RequestVarMap>();
-    // clear rank container
-    for (auto &requestVar : requestVars) {
-        state = state->remove<RequestVarMap>(requestVar.first);
+    if (state->get<RequestVarMap>().isEmpty() &&
+        state->get<RequestArrayMap>().isEmpty()) {
+        return;
     }
-    ctx.addTransition(state);
+    transition(ctx, state->remove<RequestVarMap>()
+                        ->remove<RequestArrayMap>()
+                        ->remove<RequestHandleMap>());
 }
 
 }  // end of namespace: mpi
@@ -26,29 +26,53 @@
 #define MPICHECKERPATHSENSITIVE_HPP_BKYOQUPL
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
-#include "MPIFunctionClassifier.hpp"
 #include "MPITypes.hpp"
-#include "MPIBugReporter.hpp"
+#include "MPISharedContext.hpp"
 
 namespace mpi {
 
 class MPICheckerPathSensitive {
 public:
     MPICheckerPathSensitive(clang::ento::AnalysisManager &analysisManager,
-                            const clang::ento::CheckerBase *checkerBase,
-                            clang::ento::BugReporter &bugReporter)
-        : funcClassifier_{analysisManager},
-          bugReporter_{bugReporter, *checkerBase, analysisManager} {}
+                            const clang::ento::CheckerBase &checkerBase,
+                            clang::ento::BugReporter &bugReporter,
+                            MPISharedContext &sharedContext)
+        : checkerBase_{checkerBase},
+          funcClassifier_{sharedContext.funcClassifier()},
+          statistics_{sharedContext.statistics()},
+          bugReporter_{bugReporter, checkerBase, analysisManager,
+                       sharedContext.bugTypes(), sharedContext.statistics()} {}
 
     void checkDoubleNonblocking(const clang::CallExpr *,
                                 clang::ento::CheckerContext &) const;
     void checkWaitUsage(const clang::CallExpr *,
                         clang::ento::CheckerContext &) const;
+    void checkPartialCompletion(const clang::CallExpr *,
+                                clang::ento::CheckerContext &) const;
+    void checkTestUsage(const clang::CallExpr *,
+                        clang::ento::CheckerContext &) const;
+    void checkTestFlag(const clang::CallExpr *,
+                       clang::ento::CheckerContext &) const;
     void checkMissingWaits(clang::ento::CheckerContext &);
+    void checkDeadRequests(clang::ento::SymbolReaper &,
+                           clang::ento::CheckerContext &) const;
     void clearRequestVars(clang::ento::CheckerContext &) const;
 
 private:
-    MPIFunctionClassifier funcClassifier_;
+    clang::ento::ExplodedNode *transition(clang::ento::CheckerContext &,
+                                          clang::ento::ProgramStateRef) const;
+    clang::ento::ExplodedNode *useTransition(
+        clang::ento::CheckerContext &, clang::ento::ProgramStateRef) const;
+    const clang::CallExpr *lastRequestUser(
+        const clang::ento::ExplodedNode *,
+        const clang::ento::MemRegion *) const;
+    const clang::CallExpr *lastArrayUser(
+        const clang::ento::ExplodedNode *,
+        const clang::ento::MemRegion *) const;
+
+    const clang::ento::CheckerBase &checkerBase_;
+    const MPIFunctionClassifier &funcClassifier_;
+    MPIStatistics &statistics_;
     MPIBugReporter bugReporter_;
 };
 }  // end of namespace: mpi
@@ -0,0 +1,247 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#include "MPIDatatype.hpp"
+#include "clang/Lex/Lexer.h"
+#include "clang/Lex/MacroInfo.h"
+#include "clang/Lex/Preprocessor.h"
+
+using namespace clang;
+using namespace ento;
+
+namespace mpi {
+
+namespace {
+
+struct DatatypeName {
+    const char *name_;
+    MPIDatatype datatype_;
+};
+
+// canonical name first for each datatype, followed by its aliases
+const DatatypeName kDatatypeNames[] = {
+    {"MPI_CHAR", MPIDatatype::kChar},
+    {"MPI_SIGNED_CHAR", MPIDatatype::kSignedChar},
+    {"MPI_UNSIGNED_CHAR", MPIDatatype::kUnsignedChar},
+    {"MPI_WCHAR", MPIDatatype::kWChar},
+    {"MPI_SHORT", MPIDatatype::kShort},
+    {"MPI_INT", MPIDatatype::kInt},
+    {"MPI_LONG", MPIDatatype::kLong},
+    {"MPI_LONG_LONG", MPIDatatype::kLongLong},
+    {"MPI_LONG_LONG_INT", MPIDatatype::kLongLong},
+    {"MPI_UNSIGNED_SHORT", MPIDatatype::kUnsignedShort},
+    {"MPI_UNSIGNED", MPIDatatype::kUnsigned},
+    {"MPI_UNSIGNED_LONG", MPIDatatype::kUnsignedLong},
+    {"MPI_UNSIGNED_LONG_LONG", MPIDatatype::kUnsignedLongLong},
+    {"MPI_FLOAT", MPIDatatype::kFloat},
+    {"MPI_DOUBLE", MPIDatatype::kDouble},
+    {"MPI_LONG_DOUBLE", MPIDatatype::kLongDouble},
+    {"MPI_C_BOOL", MPIDatatype::kCBool},
+    {"MPI_C_FLOAT_COMPLEX", MPIDatatype::kCFloatComplex},
+    {"MPI_C_COMPLEX", MPIDatatype::kCFloatComplex},
+    {"MPI_C_DOUBLE_COMPLEX", MPIDatatype::kCDoubleComplex},
+    {"MPI_C_LONG_DOUBLE_COMPLEX", MPIDatatype::kCLongDoubleComplex},
+    {"MPI_INT8_T", MPIDatatype::kInt8},
+    {"MPI_INT16_T", MPIDatatype::kInt16},
+    {"MPI_INT32_T", MPIDatatype::kInt32},
+    {"MPI_INT64_T", MPIDatatype::kInt64},
+    {"MPI_UINT8_T", MPIDatatype::kUInt8},
+    {"MPI_UINT16_T", MPIDatatype::kUInt16},
+    {"MPI_UINT32_T", MPIDatatype::kUInt32},
+    {"MPI_UINT64_T", MPIDatatype::kUInt64}};
+
+// constant variables followed through their initializers, bounds
+// self or mutually referencing initializers like: const MPI_Datatype t = t;
+const unsigned kMaxInitializerDepth{8};
+
+}  // end of anonymous namespace
+
+/**
+ * Returns the canonical name of a predefined datatype.
+ *
+ * @param datatype
+ *
+ * @return name, empty for kUnknown
+ */
+llvm::StringRef datatypeName(const MPIDatatype datatype) {
+    for (const DatatypeName &entry : kDatatypeNames) {
+        if (entry.datatype_ == datatype) return entry.name_;
+    }
+    return "";
+}
+
+MPIDatatypeResolver::MPIDatatypeResolver(AnalysisManager &analysisManager)
+    : astContext_{analysisManager.getASTContext()},
+      sourceManager_{analysisManager.getSourceManager()},
+      langOptions_{analysisManager.getASTContext().getLangOpts()} {
+    for (const DatatypeName &entry : kDatatypeNames) {
+        names_[entry.name_] = entry.datatype_;
+    }
+    collectHandles(analysisManager.getPreprocessor());
+}
+
+/**
+ * Resolves a datatype argument. The argument is identified by the
+ * datatype macro it expands from, by the name of the enum constant or
+ * variable it refers to, through the initializer of constant variables
+ * or by its constant value if datatype macros expand to integers.
+ *
+ * @param expr datatype argument
+ *
+ * @return datatype, kUnknown for derived or unresolvable datatypes
+ */
+MPIDatatype MPIDatatypeResolver::resolve(const Expr *const expr) const {
+    return resolve(expr, kMaxInitializerDepth);
+}
+
+/**
+ * Resolves a datatype argument, following at most depth initializers
+ * of constant variables.
+ *
+ * @param expr datatype argument
+ * @param depth initializers left to follow
+ *
+ * @return datatype, kUnknown for derived or unresolvable datatypes
+ */
+MPIDatatype MPIDatatypeResolver::resolve(const Expr *const expr,
+                                         const unsigned depth) const {
+    const MPIDatatype macroDatatype = resolveMacro(expr);
+    if (macroDatatype != MPIDatatype::kUnknown) return macroDatatype;
+
+    if (const DeclRefExpr *declRef =
+            dyn_cast<DeclRefExpr>(expr->IgnoreParenCasts())) {
+        const ValueDecl *valueDecl = declRef->getDecl();
+        if (valueDecl->getIdentifier()) {
+            auto name = names_.find(valueDecl->getName());
+            if (name != names_.end()) return name->second;
+        }
+        const VarDecl *varDecl = dyn_cast<VarDecl>(valueDecl);
+        if (varDecl && varDecl->getType().isConstQualified() &&
+            varDecl->getInit() && depth) {
+            return resolve(varDecl->getInit(), depth - 1);
+        }
+    }
+
+    llvm::APSInt value;
+    if (!handles_.empty() && !expr->isValueDependent() &&
+        expr->EvaluateAsInt(value, astContext_)) {
+        auto handle = handles_.find(value.getLimitedValue());
+        if (handle != handles_.end()) return handle->second;
+    }
+    return MPIDatatype::kUnknown;
+}
+
+/**
+ * Checks if a buffer argument is MPI_IN_PLACE.
+ *
+ * @param expr buffer argument
+ *
+ * @return is in place
+ */
+bool MPIDatatypeResolver::isInPlace(const Expr *const expr) const {
+    for (const StringRef macroName : macroNames(expr)) {
+        if (macroName == "MPI_IN_PLACE") return true;
+    }
+    return false;
+}
+
+/**
+ * Resolves an argument by the innermost datatype macro it expands from,
+ * so that user macros defined as predefined datatypes are resolved too.
+ *
+ * @param expr datatype argument
+ *
+ * @return datatype, kUnknown if no datatype macro is involved
+ */
+MPIDatatype MPIDatatypeResolver::resolveMacro(const Expr *const expr) const {
+    for (const StringRef macroName : macroNames(expr)) {
+        auto name = names_.find(macroName);
+        if (name != names_.end()) return name->second;
+    }
+    return MPIDatatype::kUnknown;
+}
+
+/**
+ * Collects the names of the macros an argument expands from, if the
+ * whole argument stems from a single macro expansion.
+ *
+ * @param expr argument
+ *
+ * @return macro names from innermost to outermost expansion
+ */
+llvm::SmallVector<StringRef, 4> MPIDatatypeResolver::macroNames(
+    const Expr *const expr) const {
+    llvm::SmallVector<StringRef, 4> names;
+    const SourceLocation begin = expr->getLocStart();
+    if (!begin.isMacroID() ||
+        sourceManager_.getExpansionLoc(begin) !=
+            sourceManager_.getExpansionLoc(expr->getLocEnd())) {
+        return names;
+    }
+
+    for (SourceLocation loc = begin; loc.isMacroID();
+         loc = sourceManager_.getImmediateMacroCallerLoc(loc)) {
+        names.push_back(
+            Lexer::getImmediateMacroName(loc, sourceManager_, langOptions_));
+    }
+    return names;
+}
+
+/**
+ * Collects the values of datatype macros expanding to a single integer
+ * literal, like ((MPI_Datatype)0x4c00080b), to resolve folded handles.
+ *
+ * @param preprocessor
+ */
+void MPIDatatypeResolver::collectHandles(Preprocessor &preprocessor) {
+    for (const DatatypeName &entry : kDatatypeNames) {
+        IdentifierInfo *identInfo = preprocessor.getIdentifierInfo(entry.name_);
+        const MacroInfo *macroInfo = preprocessor.getMacroInfo(identInfo);
+        if (!macroInfo) continue;
+
+        const Token *literal{nullptr};
+        bool isSingleLiteral{true};
+        for (auto token = macroInfo->tokens_begin();
+             token != macroInfo->tokens_end(); ++token) {
+            if (token->is(tok::numeric_constant)) {
+                isSingleLiteral = !literal;
+                literal = &*token;
+            } else if (token->is(tok::minus)) {
+                isSingleLiteral = false;
+            }
+            if (!isSingleLiteral) break;
+        }
+        if (!literal || !isSingleLiteral) continue;
+
+        llvm::SmallString<16> buffer;
+        const StringRef spelling =
+            preprocessor.getSpelling(*literal, buffer).rtrim("uUlL");
+        uint64_t value;
+        if (!spelling.getAsInteger(0, value)) {
+            handles_.insert({value, entry.datatype_});
+        }
+    }
+}
+
+}  // end of namespace: mpi
@@ -0,0 +1,97 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef MPIDATATYPE_HPP_V8HN3QLC
+#define MPIDATATYPE_HPP_V8HN3QLC
+
+#include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+
+namespace mpi {
+
+// predefined mpi datatypes, aliases share one value
+enum class MPIDatatype {
+    kUnknown,
+    kChar,
+    kSignedChar,
+    kUnsignedChar,
+    kWChar,
+    kShort,
+    kInt,
+    kLong,
+    kLongLong,
+    kUnsignedShort,
+    kUnsigned,
+    kUnsignedLong,
+    kUnsignedLongLong,
+    kFloat,
+    kDouble,
+    kLongDouble,
+    kCBool,
+    kCFloatComplex,
+    kCDoubleComplex,
+    kCLongDoubleComplex,
+    kInt8,
+    kInt16,
+    kInt32,
+    kInt64,
+    kUInt8,
+    kUInt16,
+    kUInt32,
+    kUInt64
+};
+
+// name of a predefined datatype, empty for kUnknown
+llvm::StringRef datatypeName(const MPIDatatype);
+
+/**
+ * Resolves mpi datatype and buffer arguments to predefined handles by
+ * identity instead of comparing source text.
+ */
+class MPIDatatypeResolver {
+public:
+    MPIDatatypeResolver(clang::ento::AnalysisManager &);
+
+    MPIDatatype resolve(const clang::Expr *const) const;
+    bool isInPlace(const clang::Expr *const) const;
+
+private:
+    MPIDatatype resolve(const clang::Expr *const, const unsigned) const;
+    MPIDatatype resolveMacro(const clang::Expr *const) const;
+    llvm::SmallVector<llvm::StringRef, 4> macroNames(
+        const clang::Expr *const) const;
+    void collectHandles(clang::Preprocessor &);
+
+    const clang::ASTContext &astContext_;
+    const clang::SourceManager &sourceManager_;
+    const clang::LangOptions &langOptions_;
+    llvm::StringMap<MPIDatatype> names_;
+    // values of datatype macros expanding to integer constants
+    llvm::DenseMap<uint64_t, MPIDatatype> handles_;
+};
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: MPIDATATYPE_HPP_V8HN3QLC
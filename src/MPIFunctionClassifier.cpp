@@ -23,8 +23,6 @@
 */
 
 #include "MPIFunctionClassifier.hpp"
-#include "Utility.hpp"
-#include "Container.hpp"
 
 using namespace clang;
 using namespace ento;
@@ -32,321 +30,215 @@ using namespace ento;
 namespace mpi {
 
 // classification ––––––––––––––––––––––––––––––––––––––––––––––––––––––––––
+namespace {
+
+using C = MPIFunctionClassifier;
+
+// categories shared by all entries of a function family
+const unsigned kSendP2P = C::kMPI | C::kPointToPoint | C::kSend;
+const unsigned kRecvP2P = C::kMPI | C::kPointToPoint | C::kRecv;
+const unsigned kColl = C::kMPI | C::kCollective;
+
+/**
+ * Classification table. To support further mpi functions add an entry
+ * here, lookup cost does not depend on the number of entries.
+ */
+const struct {
+    const char *name;
+    unsigned categories;
+} kClassifiedFunctions[] = {
+    // point to point functions
+    {"MPI_Send", kSendP2P | C::kBlocking},
+    {"MPI_Isend", kSendP2P | C::kNonBlocking},
+    {"MPI_Ssend", kSendP2P | C::kBlocking},
+    {"MPI_Issend", kSendP2P | C::kNonBlocking},
+    {"MPI_Bsend", kSendP2P | C::kBlocking},
+    {"MPI_Ibsend", kSendP2P | C::kNonBlocking},
+    {"MPI_Rsend", kSendP2P | C::kBlocking},
+    {"MPI_Irsend", kSendP2P | C::kNonBlocking},
+    {"MPI_Recv", kRecvP2P | C::kBlocking},
+    {"MPI_Irecv", kRecvP2P | C::kNonBlocking},
+
+    // collective functions
+    {"MPI_Scatter", kColl | C::kPointToColl | C::kScatter | C::kBlocking},
+    {"MPI_Iscatter", kColl | C::kPointToColl | C::kScatter | C::kNonBlocking},
+    {"MPI_Gather", kColl | C::kCollToPoint | C::kGather | C::kBlocking},
+    {"MPI_Igather", kColl | C::kCollToPoint | C::kGather | C::kNonBlocking},
+    {"MPI_Allgather",
+     kColl | C::kCollToColl | C::kGather | C::kAllgather | C::kBlocking},
+    {"MPI_Iallgather",
+     kColl | C::kCollToColl | C::kGather | C::kAllgather | C::kNonBlocking},
+    {"MPI_Bcast", kColl | C::kPointToColl | C::kBcast | C::kBlocking},
+    {"MPI_Ibcast", kColl | C::kPointToColl | C::kBcast | C::kNonBlocking},
+    {"MPI_Reduce", kColl | C::kCollToPoint | C::kReduce | C::kBlocking},
+    {"MPI_Ireduce", kColl | C::kCollToPoint | C::kReduce | C::kNonBlocking},
+    {"MPI_Allreduce", kColl | C::kCollToColl | C::kReduce | C::kBlocking},
+    {"MPI_Iallreduce",
+     kColl | C::kCollToColl | C::kReduce | C::kNonBlocking},
+    {"MPI_Alltoall", kColl | C::kCollToColl | C::kAlltoall | C::kBlocking},
+    {"MPI_Ialltoall",
+     kColl | C::kCollToColl | C::kAlltoall | C::kNonBlocking},
+    {"MPI_Barrier", kColl},
+
+    // additional functions
+    {"MPI_Comm_rank", C::kMPI | C::kCommRank},
+    {"MPI_Wait", C::kMPI | C::kWait},
+    {"MPI_Waitall", C::kMPI | C::kWaitall},
+    {"MPI_Waitany", C::kMPI | C::kWaitany},
+    {"MPI_Waitsome", C::kMPI | C::kWaitsome},
+    {"MPI_Test", C::kMPI | C::kTest},
+    {"MPI_Testall", C::kMPI | C::kTestall},
+    {"MPI_Testany", C::kMPI | C::kTestany},
+    {"MPI_Testsome", C::kMPI | C::kTestsome},
+    {"MPI_Request_free", C::kMPI | C::kRequestFree},
+};
+
+}  // end of anonymous namespace
+
 /**
  * Initializes function identifiers. Instead of using strings,
  * indentifier-pointers are initially captured
- * to recognize functions during analysis by comparison later.
+ * to recognize functions during analysis by a single lookup later.
  *
  * @param current ast-context used for analysis
  */
 void MPIFunctionClassifier::identifierInit(
-    clang::ento::AnalysisManager &analysisManager) {
-    // init function identifiers
-    initPointToPointIdentifiers(analysisManager);
-    initCollectiveIdentifiers(analysisManager);
-    initAdditionalIdentifiers(analysisManager);
-}
-
-void MPIFunctionClassifier::initPointToPointIdentifiers(
-    clang::ento::AnalysisManager &analysisManager) {
-    ASTContext &context = analysisManager.getASTContext();
-
-    // copy identifiers into the correct classification containers
-    identInfo_MPI_Send_ = &context.Idents.get("MPI_Send");
-    mpiSendTypes_.push_back(identInfo_MPI_Send_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Send_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Send_);
-    mpiType_.push_back(identInfo_MPI_Send_);
-    assert(identInfo_MPI_Send_);
-
-    identInfo_MPI_Isend_ = &context.Idents.get("MPI_Isend");
-    mpiSendTypes_.push_back(identInfo_MPI_Isend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Isend_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Isend_);
-    mpiType_.push_back(identInfo_MPI_Isend_);
-    assert(identInfo_MPI_Isend_);
-
-    identInfo_MPI_Ssend_ = &context.Idents.get("MPI_Ssend");
-    mpiSendTypes_.push_back(identInfo_MPI_Ssend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Ssend_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Ssend_);
-    mpiType_.push_back(identInfo_MPI_Ssend_);
-    assert(identInfo_MPI_Ssend_);
-
-    identInfo_MPI_Issend_ = &context.Idents.get("MPI_Issend");
-    mpiSendTypes_.push_back(identInfo_MPI_Issend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Issend_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Issend_);
-    mpiType_.push_back(identInfo_MPI_Issend_);
-    assert(identInfo_MPI_Issend_);
-
-    identInfo_MPI_Bsend_ = &context.Idents.get("MPI_Bsend");
-    mpiSendTypes_.push_back(identInfo_MPI_Bsend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Bsend_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Bsend_);
-    mpiType_.push_back(identInfo_MPI_Bsend_);
-    assert(identInfo_MPI_Bsend_);
-
-    identInfo_MPI_Ibsend_ = &context.Idents.get("MPI_Ibsend");
-    mpiSendTypes_.push_back(identInfo_MPI_Ibsend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Ibsend_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Ibsend_);
-    mpiType_.push_back(identInfo_MPI_Ibsend_);
-    assert(identInfo_MPI_Ibsend_);
-
-    identInfo_MPI_Rsend_ = &context.Idents.get("MPI_Rsend");
-    mpiSendTypes_.push_back(identInfo_MPI_Rsend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Rsend_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Rsend_);
-    mpiType_.push_back(identInfo_MPI_Rsend_);
-    assert(identInfo_MPI_Rsend_);
-
-    identInfo_MPI_Irsend_ = &context.Idents.get("MPI_Irsend");
-    mpiSendTypes_.push_back(identInfo_MPI_Irsend_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Irsend_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Irsend_);
-    mpiType_.push_back(identInfo_MPI_Irsend_);
-    assert(identInfo_MPI_Irsend_);
-
-    identInfo_MPI_Recv_ = &context.Idents.get("MPI_Recv");
-    mpiRecvTypes_.push_back(identInfo_MPI_Recv_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Recv_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Recv_);
-    mpiType_.push_back(identInfo_MPI_Recv_);
-    assert(identInfo_MPI_Recv_);
-
-    identInfo_MPI_Irecv_ = &context.Idents.get("MPI_Irecv");
-    mpiRecvTypes_.push_back(identInfo_MPI_Irecv_);
-    mpiPointToPointTypes_.push_back(identInfo_MPI_Irecv_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Irecv_);
-    mpiType_.push_back(identInfo_MPI_Irecv_);
-    assert(identInfo_MPI_Irecv_);
-}
-
-void MPIFunctionClassifier::initCollectiveIdentifiers(
     clang::ento::AnalysisManager &analysisManager) {
     ASTContext &context = analysisManager.getASTContext();
 
-    // copy identifiers into the correct classification containers
-    identInfo_MPI_Scatter_ = &context.Idents.get("MPI_Scatter");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Scatter_);
-    mpiPointToCollTypes_.push_back(identInfo_MPI_Scatter_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Scatter_);
-    mpiType_.push_back(identInfo_MPI_Scatter_);
-    assert(identInfo_MPI_Scatter_);
-
-    identInfo_MPI_Iscatter_ = &context.Idents.get("MPI_Iscatter");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Iscatter_);
-    mpiPointToCollTypes_.push_back(identInfo_MPI_Iscatter_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Iscatter_);
-    mpiType_.push_back(identInfo_MPI_Iscatter_);
-    assert(identInfo_MPI_Iscatter_);
-
-    identInfo_MPI_Gather_ = &context.Idents.get("MPI_Gather");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Gather_);
-    mpiCollToPointTypes_.push_back(identInfo_MPI_Gather_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Gather_);
-    mpiType_.push_back(identInfo_MPI_Gather_);
-    assert(identInfo_MPI_Gather_);
-
-    identInfo_MPI_Igather_ = &context.Idents.get("MPI_Igather");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Igather_);
-    mpiCollToPointTypes_.push_back(identInfo_MPI_Igather_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Gather_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Igather_);
-    mpiType_.push_back(identInfo_MPI_Igather_);
-    assert(identInfo_MPI_Igather_);
-
-    identInfo_MPI_Allgather_ = &context.Idents.get("MPI_Allgather");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Allgather_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Allgather_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Allgather_);
-    mpiType_.push_back(identInfo_MPI_Allgather_);
-    assert(identInfo_MPI_Allgather_);
-
-    identInfo_MPI_Iallgather_ = &context.Idents.get("MPI_Iallgather");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Iallgather_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Iallgather_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Iallgather_);
-    mpiType_.push_back(identInfo_MPI_Iallgather_);
-    assert(identInfo_MPI_Iallgather_);
-
-    identInfo_MPI_Bcast_ = &context.Idents.get("MPI_Bcast");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Bcast_);
-    mpiPointToCollTypes_.push_back(identInfo_MPI_Bcast_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Bcast_);
-    mpiType_.push_back(identInfo_MPI_Bcast_);
-    assert(identInfo_MPI_Bcast_);
-
-    identInfo_MPI_Ibcast_ = &context.Idents.get("MPI_Ibcast");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Ibcast_);
-    mpiPointToCollTypes_.push_back(identInfo_MPI_Ibcast_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Ibcast_);
-    mpiType_.push_back(identInfo_MPI_Ibcast_);
-    assert(identInfo_MPI_Ibcast_);
-
-    identInfo_MPI_Reduce_ = &context.Idents.get("MPI_Reduce");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Reduce_);
-    mpiCollToPointTypes_.push_back(identInfo_MPI_Reduce_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Reduce_);
-    mpiType_.push_back(identInfo_MPI_Reduce_);
-    assert(identInfo_MPI_Reduce_);
-
-    identInfo_MPI_Ireduce_ = &context.Idents.get("MPI_Ireduce");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Ireduce_);
-    mpiCollToPointTypes_.push_back(identInfo_MPI_Ireduce_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Ireduce_);
-    mpiType_.push_back(identInfo_MPI_Ireduce_);
-    assert(identInfo_MPI_Ireduce_);
-
-    identInfo_MPI_Allreduce_ = &context.Idents.get("MPI_Allreduce");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Allreduce_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Allreduce_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Allreduce_);
-    mpiType_.push_back(identInfo_MPI_Allreduce_);
-    assert(identInfo_MPI_Allreduce_);
-
-    identInfo_MPI_Iallreduce_ = &context.Idents.get("MPI_Iallreduce");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Iallreduce_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Iallreduce_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Iallreduce_);
-    mpiType_.push_back(identInfo_MPI_Iallreduce_);
-    assert(identInfo_MPI_Iallreduce_);
-
-    identInfo_MPI_Alltoall_ = &context.Idents.get("MPI_Alltoall");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Alltoall_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Alltoall_);
-    mpiBlockingTypes_.push_back(identInfo_MPI_Alltoall_);
-    mpiType_.push_back(identInfo_MPI_Alltoall_);
-    assert(identInfo_MPI_Alltoall_);
-
-    identInfo_MPI_Ialltoall_ = &context.Idents.get("MPI_Ialltoall");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Ialltoall_);
-    mpiCollToCollTypes_.push_back(identInfo_MPI_Ialltoall_);
-    mpiNonBlockingTypes_.push_back(identInfo_MPI_Ialltoall_);
-    mpiType_.push_back(identInfo_MPI_Ialltoall_);
-    assert(identInfo_MPI_Ialltoall_);
-}
-
-void MPIFunctionClassifier::initAdditionalIdentifiers(
-    clang::ento::AnalysisManager &analysisManager) {
-    ASTContext &context = analysisManager.getASTContext();
-
-    identInfo_MPI_Comm_rank_ = &context.Idents.get("MPI_Comm_rank");
-    mpiType_.push_back(identInfo_MPI_Comm_rank_);
-    assert(identInfo_MPI_Comm_rank_);
-
-    identInfo_MPI_Wait_ = &context.Idents.get("MPI_Wait");
-    mpiType_.push_back(identInfo_MPI_Wait_);
-    assert(identInfo_MPI_Wait_);
-
-    identInfo_MPI_Waitall_ = &context.Idents.get("MPI_Waitall");
-    mpiType_.push_back(identInfo_MPI_Waitall_);
-    assert(identInfo_MPI_Waitall_);
-
-    identInfo_MPI_Barrier_ = &context.Idents.get("MPI_Barrier");
-    mpiCollectiveTypes_.push_back(identInfo_MPI_Barrier_);
-    mpiType_.push_back(identInfo_MPI_Barrier_);
-    assert(identInfo_MPI_Barrier_);
+    for (const auto &function : kClassifiedFunctions) {
+        IdentifierInfo *identInfo = &context.Idents.get(function.name);
+        assert(identInfo);
+        categories_[identInfo] = function.categories;
+    }
 }
 
 // general identifiers–––––––––––––––––––––––––––––––––––––––––––––––––
 bool MPIFunctionClassifier::isMPIType(const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiType_, identInfo);
+    return hasCategory(identInfo, kMPI);
 }
 
 bool MPIFunctionClassifier::isBlockingType(
     const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiBlockingTypes_, identInfo);
+    return hasCategory(identInfo, kBlocking);
 }
 
 bool MPIFunctionClassifier::isNonBlockingType(
     const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiNonBlockingTypes_, identInfo);
+    return hasCategory(identInfo, kNonBlocking);
 }
 
 // point to point identifiers––––––––––––––––––––––––––––––––––––––––––
 bool MPIFunctionClassifier::isPointToPointType(
     const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiPointToPointTypes_, identInfo);
+    return hasCategory(identInfo, kPointToPoint);
 }
 
 bool MPIFunctionClassifier::isSendType(const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiSendTypes_, identInfo);
+    return hasCategory(identInfo, kSend);
 }
 
 bool MPIFunctionClassifier::isRecvType(const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiRecvTypes_, identInfo);
+    return hasCategory(identInfo, kRecv);
 }
 
 // collective identifiers––––––––––––––––––––––––––––––––––––––––––––––
 bool MPIFunctionClassifier::isCollectiveType(
     const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiCollectiveTypes_, identInfo);
+    return hasCategory(identInfo, kCollective);
 }
 
 bool MPIFunctionClassifier::isCollToColl(
     const IdentifierInfo *identInfo) const {
-    return cont::isContained(mpiCollToCollTypes_, identInfo);
+    return hasCategory(identInfo, kCollToColl);
 }
 
 bool MPIFunctionClassifier::isScatterType(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Scatter_ ||
-           identInfo == identInfo_MPI_Iscatter_;
+    return hasCategory(identInfo, kScatter);
 }
 
 bool MPIFunctionClassifier::isGatherType(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Gather_ ||
-           identInfo == identInfo_MPI_Igather_ ||
-           identInfo == identInfo_MPI_Allgather_ ||
-           identInfo == identInfo_MPI_Iallgather_;
+    return hasCategory(identInfo, kGather);
 }
 
 bool MPIFunctionClassifier::isAllgatherType(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Allgather_ ||
-           identInfo == identInfo_MPI_Iallgather_;
+    return hasCategory(identInfo, kAllgather);
 }
 
 bool MPIFunctionClassifier::isAlltoallType(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Alltoall_ ||
-           identInfo == identInfo_MPI_Ialltoall_;
+    return hasCategory(identInfo, kAlltoall);
 }
 
 bool MPIFunctionClassifier::isBcastType(const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Bcast_ ||
-           identInfo == identInfo_MPI_Ibcast_;
+    return hasCategory(identInfo, kBcast);
 }
 
 bool MPIFunctionClassifier::isReduceType(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Reduce_ ||
-           identInfo == identInfo_MPI_Ireduce_ ||
-           identInfo == identInfo_MPI_Allreduce_ ||
-           identInfo == identInfo_MPI_Iallreduce_;
+    return hasCategory(identInfo, kReduce);
 }
 
 // additional identifiers ––––––––––––––––––––––––––––––––––––––––––––––
 bool MPIFunctionClassifier::isMPI_Comm_rank(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Comm_rank_;
+    return hasCategory(identInfo, kCommRank);
 }
 
 bool MPIFunctionClassifier::isMPI_Wait(const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Wait_;
+    return hasCategory(identInfo, kWait);
 }
 
 bool MPIFunctionClassifier::isMPI_Waitall(
     const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Waitall_;
+    return hasCategory(identInfo, kWaitall);
 }
 
+bool MPIFunctionClassifier::isMPI_Waitany(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kWaitany);
+}
+
+bool MPIFunctionClassifier::isMPI_Waitsome(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kWaitsome);
+}
+
+bool MPIFunctionClassifier::isMPI_Test(const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kTest);
+}
+
+bool MPIFunctionClassifier::isMPI_Testall(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kTestall);
+}
+
+bool MPIFunctionClassifier::isMPI_Testany(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kTestany);
+}
+
+bool MPIFunctionClassifier::isMPI_Testsome(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kTestsome);
+}
+
+bool MPIFunctionClassifier::isMPI_Request_free(
+    const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kRequestFree);
+}
+
+// completes all requests passed, reported if misused
 bool MPIFunctionClassifier::isWaitType(const IdentifierInfo *identInfo) const {
-    return identInfo == identInfo_MPI_Wait_ ||
-           identInfo == identInfo_MPI_Waitall_;
+    return hasCategory(identInfo, kWait | kWaitall);
+}
+
+// completes requests only if the flag set by the call is true
+bool MPIFunctionClassifier::isTestType(const IdentifierInfo *identInfo) const {
+    return hasCategory(identInfo, kTest | kTestall | kTestany);
 }
 
 }  // end of namespace: mpi
@@ -26,6 +26,7 @@
 #define MPIFUNCTIONCLASSIFIER_HPP_Q3AOUNFC
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace mpi {
 
@@ -59,51 +60,65 @@ public:
     bool isMPI_Comm_rank(const clang::IdentifierInfo *const) const;
     bool isMPI_Wait(const clang::IdentifierInfo *const) const;
     bool isMPI_Waitall(const clang::IdentifierInfo *const) const;
+    bool isMPI_Waitany(const clang::IdentifierInfo *const) const;
+    bool isMPI_Waitsome(const clang::IdentifierInfo *const) const;
+    bool isMPI_Test(const clang::IdentifierInfo *const) const;
+    bool isMPI_Testall(const clang::IdentifierInfo *const) const;
+    bool isMPI_Testany(const clang::IdentifierInfo *const) const;
+    bool isMPI_Testsome(const clang::IdentifierInfo *const) const;
+    bool isMPI_Request_free(const clang::IdentifierInfo *const) const;
     bool isWaitType(const clang::IdentifierInfo *const) const;
+    bool isTestType(const clang::IdentifierInfo *const) const;
+
+    // categories a function can belong to, combined as bitmask
+    enum Category : unsigned {
+        kMPI = 1u << 0,
+        kBlocking = 1u << 1,
+        kNonBlocking = 1u << 2,
+        kPointToPoint = 1u << 3,
+        kSend = 1u << 4,
+        kRecv = 1u << 5,
+        kCollective = 1u << 6,
+        kPointToColl = 1u << 7,
+        kCollToPoint = 1u << 8,
+        kCollToColl = 1u << 9,
+        kScatter = 1u << 10,
+        kGather = 1u << 11,
+        kAllgather = 1u << 12,
+        kAlltoall = 1u << 13,
+        kReduce = 1u << 14,
+        kBcast = 1u << 15,
+        kCommRank = 1u << 16,
+        kWait = 1u << 17,
+        kWaitall = 1u << 18,
+        kWaitany = 1u << 19,
+        kWaitsome = 1u << 20,
+        kTest = 1u << 21,
+        kTestall = 1u << 22,
+        kTestany = 1u << 23,
+        kTestsome = 1u << 24,
+        kRequestFree = 1u << 25
+    };
+
+    /**
+     * Returns the category bitmask for an identifier, 0 for non mpi
+     * functions.
+     */
+    unsigned categories(const clang::IdentifierInfo *const identInfo) const {
+        auto it = categories_.find(identInfo);
+        return it != categories_.end() ? it->second : 0;
+    }
 
 private:
     void identifierInit(clang::ento::AnalysisManager &);
-    void initPointToPointIdentifiers(clang::ento::AnalysisManager &);
-    void initCollectiveIdentifiers(clang::ento::AnalysisManager &);
-    void initAdditionalIdentifiers(clang::ento::AnalysisManager &);
+
+    bool hasCategory(const clang::IdentifierInfo *const identInfo,
+                     const unsigned category) const {
+        return categories(identInfo) & category;
+    }
 
     // to enable classification of mpi-functions during analysis
-    llvm::SmallVector<clang::IdentifierInfo *, 8> mpiSendTypes_;
-    llvm::SmallVector<clang::IdentifierInfo *, 2> mpiRecvTypes_;
-
-    llvm::SmallVector<clang::IdentifierInfo *, 12> mpiBlockingTypes_;
-    llvm::SmallVector<clang::IdentifierInfo *, 12> mpiNonBlockingTypes_;
-
-    llvm::SmallVector<clang::IdentifierInfo *, 10> mpiPointToPointTypes_;
-    llvm::SmallVector<clang::IdentifierInfo *, 16> mpiCollectiveTypes_;
-
-    llvm::SmallVector<clang::IdentifierInfo *, 4> mpiPointToCollTypes_;
-    llvm::SmallVector<clang::IdentifierInfo *, 4> mpiCollToPointTypes_;
-    llvm::SmallVector<clang::IdentifierInfo *, 6> mpiCollToCollTypes_;
-
-    llvm::SmallVector<clang::IdentifierInfo *, 32> mpiType_;
-
-    // point to point functions
-    clang::IdentifierInfo *identInfo_MPI_Send_{nullptr},
-        *identInfo_MPI_Isend_{nullptr}, *identInfo_MPI_Ssend_{nullptr},
-        *identInfo_MPI_Issend_{nullptr}, *identInfo_MPI_Bsend_{nullptr},
-        *identInfo_MPI_Ibsend_{nullptr}, *identInfo_MPI_Rsend_{nullptr},
-        *identInfo_MPI_Irsend_{nullptr}, *identInfo_MPI_Recv_{nullptr},
-        *identInfo_MPI_Irecv_{nullptr};
-
-    // collective functions
-    clang::IdentifierInfo *identInfo_MPI_Scatter_{nullptr},
-        *identInfo_MPI_Iscatter_{nullptr}, *identInfo_MPI_Gather_{nullptr},
-        *identInfo_MPI_Igather_{nullptr}, *identInfo_MPI_Allgather_{nullptr},
-        *identInfo_MPI_Iallgather_{nullptr}, *identInfo_MPI_Bcast_{nullptr},
-        *identInfo_MPI_Ibcast_{nullptr}, *identInfo_MPI_Reduce_{nullptr},
-        *identInfo_MPI_Ireduce_{nullptr}, *identInfo_MPI_Allreduce_{nullptr},
-        *identInfo_MPI_Iallreduce_{nullptr}, *identInfo_MPI_Alltoall_{nullptr},
-        *identInfo_MPI_Ialltoall_{nullptr}, *identInfo_MPI_Barrier_{nullptr};
-
-    // additional functions
-    clang::IdentifierInfo *identInfo_MPI_Comm_rank_{nullptr},
-        *identInfo_MPI_Wait_{nullptr}, *identInfo_MPI_Waitall_{nullptr};
+    llvm::DenseMap<const clang::IdentifierInfo *, unsigned> categories_;
 };
 
 }  // end of namespace: mpi
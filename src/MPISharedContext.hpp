@@ -0,0 +1,104 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef MPISHAREDCONTEXT_HPP_R7DW2KQE
+#define MPISHAREDCONTEXT_HPP_R7DW2KQE
+
+#include "MPIFunctionClassifier.hpp"
+#include "MPIBugReporter.hpp"
+#include "CanonicalForm.hpp"
+#include "MPIDatatype.hpp"
+#include "TypeVisitor.hpp"
+#include "MPIArena.hpp"
+#include "llvm/ADT/DenseMap.h"
+
+namespace mpi {
+
+// analyzer-config option, directory to write statistics as json to
+const char kStatsDirOption[] = "mpi-stats-dir";
+
+/**
+ * State shared by the ast and path sensitive checks of one translation
+ * unit. It is created once per ast context so that identifier lookups
+ * and bug type construction are not repeated by every consumer.
+ */
+class MPISharedContext {
+public:
+    MPISharedContext(clang::ento::AnalysisManager &analysisManager,
+                     const clang::ento::CheckerBase &checkerBase)
+        : astContext_{analysisManager.getASTContext()},
+          funcClassifier_{analysisManager},
+          datatypes_{analysisManager},
+          bugTypes_{checkerBase},
+          statistics_{analysisManager.getAnalyzerOptions().PrintStats ||
+                      !analysisManager.getAnalyzerOptions()
+                           .Config.lookup(kStatsDirOption)
+                           .empty()} {}
+
+    const clang::ASTContext &astContext() const { return astContext_; }
+    const MPIFunctionClassifier &funcClassifier() const {
+        return funcClassifier_;
+    }
+    const MPIDatatypeResolver &datatypes() const { return datatypes_; }
+    MPIBugTypes &bugTypes() { return bugTypes_; }
+    MPIStatistics &statistics() { return statistics_; }
+    TypeClassCache &typeClasses() { return typeClasses_; }
+    CanonicalFormTable &canonicalForms() { return canonicalForms_; }
+    size_t callArenaBytes() const { return callArena_.bytes(); }
+
+    /**
+     * Returns the description of an mpi call, parsed on first request.
+     *
+     * @param callExpr mpi call
+     *
+     * @return call description
+     */
+    const MPICall &mpiCall(const clang::CallExpr *const callExpr) {
+        const MPICall *&mpiCall = mpiCalls_[callExpr];
+        if (!mpiCall) {
+            // calls are numbered in order of their first request
+            mpiCall = callArena_.createCall(callExpr, mpiCalls_.size() - 1,
+                                            callArena_, canonicalForms_);
+            statistics_.count(MPIStatistics::kMPICalls);
+        }
+        return *mpiCall;
+    }
+
+private:
+    const clang::ASTContext &astContext_;
+    const MPIFunctionClassifier funcClassifier_;
+    const MPIDatatypeResolver datatypes_;
+    MPIBugTypes bugTypes_;
+    MPIStatistics statistics_;
+    CanonicalFormTable canonicalForms_;
+    TypeClassCache typeClasses_;
+    // calls are shared by the ast and path sensitive checks
+    // and therefore live as long as the ast context
+    MPIArena callArena_;
+    llvm::DenseMap<const clang::CallExpr *, const MPICall *> mpiCalls_;
+};
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: MPISHAREDCONTEXT_HPP_R7DW2KQE
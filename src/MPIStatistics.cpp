@@ -0,0 +1,159 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#include "MPIStatistics.hpp"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include <algorithm>
+
+#define DEBUG_TYPE "MPIChecker"
+
+STATISTIC(NumRankCases, "Rank cases collected");
+STATISTIC(NumMPICalls, "MPI calls described");
+STATISTIC(NumSendRecvPairChecks, "Send and receive pairs compared");
+STATISTIC(NumStateTransitions, "State transitions added by the checker");
+STATISTIC(NumReports, "Reports emitted by the checker");
+
+namespace mpi {
+
+namespace {
+
+// names used in printed tables and json, indexed by phase
+const char *const kPhaseNames[] = {
+    "traversal",    "collectRankCases", "pointToPointSchema",
+    "reachability", "preStmt",          "postStmt",
+    "deadSymbols",  "endFunction"};
+
+// names used in json, indexed by counter
+const char *const kCounterNames[] = {"rankCases", "mpiCalls",
+                                     "sendRecvPairChecks",
+                                     "stateTransitions", "reports"};
+
+llvm::Statistic *const kStatistics[] = {
+    &NumRankCases, &NumMPICalls, &NumSendRecvPairChecks,
+    &NumStateTransitions, &NumReports};
+
+/**
+ * Writes a string as json string literal.
+ *
+ * @param text
+ * @param outStream
+ */
+void writeJSONString(const std::string &text, llvm::raw_ostream &outStream) {
+    outStream << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            outStream << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            outStream << llvm::format("\\u%04x", c);
+        } else {
+            outStream << c;
+        }
+    }
+    outStream << '"';
+}
+
+}  // end of anonymous namespace
+
+/**
+ * Count an event for the translation unit and the llvm statistics.
+ *
+ * @param counter
+ * @param count number of events
+ */
+void MPIStatistics::count(const Counter counter, const unsigned count) {
+    counts_[counter] += count;
+    *kStatistics[counter] += count;
+}
+
+/**
+ * Record the bytes currently allocated by the arenas of the translation
+ * unit, keeping the maximum.
+ *
+ * @param bytes
+ */
+void MPIStatistics::recordArenaBytes(const size_t bytes) {
+    arenaPeakBytes_ = std::max(arenaPeakBytes_, bytes);
+}
+
+/**
+ * Print timers of the phases as table, in seconds,
+ * followed by the peak arena memory.
+ *
+ * @param outStream
+ */
+void MPIStatistics::print(llvm::raw_ostream &outStream) const {
+    outStream << "MPI-Checker phase timers (wall, user, system seconds):\n";
+    for (unsigned phase = 0; phase < kPhaseCount; ++phase) {
+        outStream << llvm::format("  %-20s %10.4f %10.4f %10.4f\n",
+                                  kPhaseNames[phase],
+                                  times_[phase].getWallTime(),
+                                  times_[phase].getUserTime(),
+                                  times_[phase].getSystemTime());
+    }
+    outStream << "MPI-Checker arena peak bytes: " << arenaPeakBytes_ << "\n";
+}
+
+/**
+ * Write timers, counters and peak arena memory as json object to a file,
+ * replacing it.
+ *
+ * @param path file to write
+ * @param mainFile main file of the translation unit
+ *
+ * @return true if the file was written
+ */
+bool MPIStatistics::writeJSON(const std::string &path,
+                              const std::string &mainFile) const {
+    std::error_code errorCode;
+    llvm::raw_fd_ostream outStream{path, errorCode, llvm::sys::fs::F_Text};
+    if (errorCode) return false;
+
+    outStream << "{\n  \"file\": ";
+    writeJSONString(mainFile, outStream);
+    outStream << ",\n  \"timers\": {";
+    for (unsigned phase = 0; phase < kPhaseCount; ++phase) {
+        outStream << (phase ? ",\n    \"" : "\n    \"") << kPhaseNames[phase]
+                  << llvm::format("\": {\"wall\": %.6f, \"user\": %.6f, "
+                                  "\"system\": %.6f}",
+                                  times_[phase].getWallTime(),
+                                  times_[phase].getUserTime(),
+                                  times_[phase].getSystemTime());
+    }
+    outStream << "\n  },\n  \"counters\": {";
+    for (unsigned counter = 0; counter < kCounterCount; ++counter) {
+        outStream << (counter ? ",\n    \"" : "\n    \"")
+                  << kCounterNames[counter] << "\": " << counts_[counter];
+    }
+    outStream << "\n  },\n  \"arenaPeakBytes\": " << arenaPeakBytes_ << "\n}\n";
+    outStream.close();
+    if (outStream.has_error()) {
+        outStream.clear_error();
+        return false;
+    }
+    return true;
+}
+
+}  // end of namespace: mpi
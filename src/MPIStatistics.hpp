@@ -0,0 +1,102 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef MPISTATISTICS_HPP_W4QJ7ZAD
+#define MPISTATISTICS_HPP_W4QJ7ZAD
+
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+namespace mpi {
+
+/**
+ * Timers, counters and peak arena memory of the checks for one translation
+ * unit. Counters are also added to the llvm statistics printed by
+ * -analyzer-stats.
+ * Timers only run if enabled, as reading the clock is not free.
+ */
+class MPIStatistics {
+public:
+    // analysis phases timed
+    enum Phase : unsigned {
+        kTraversal,
+        kCollectRankCases,
+        kPointToPointSchema,
+        kReachability,
+        kPreStmt,
+        kPostStmt,
+        kDeadSymbols,
+        kEndFunction,
+        kPhaseCount
+    };
+
+    // events counted
+    enum Counter : unsigned {
+        kRankCases,
+        kMPICalls,
+        kSendRecvPairChecks,
+        kStateTransitions,
+        kReports,
+        kCounterCount
+    };
+
+    explicit MPIStatistics(const bool isEnabled) : isEnabled_{isEnabled} {}
+
+    void count(const Counter, const unsigned = 1);
+    void recordArenaBytes(const size_t);
+    void print(llvm::raw_ostream &) const;
+    bool writeJSON(const std::string &, const std::string &) const;
+
+    // times a phase for the lifetime of the object
+    class PhaseTimer {
+    public:
+        PhaseTimer(MPIStatistics &statistics, const Phase phase)
+            : statistics_{statistics.isEnabled_ ? &statistics : nullptr},
+              phase_{phase} {
+            if (statistics_) start_ = llvm::TimeRecord::getCurrentTime(true);
+        }
+        ~PhaseTimer() {
+            if (!statistics_) return;
+            llvm::TimeRecord elapsed = llvm::TimeRecord::getCurrentTime(false);
+            elapsed -= start_;
+            statistics_->times_[phase_] += elapsed;
+        }
+
+    private:
+        MPIStatistics *const statistics_;
+        const Phase phase_;
+        llvm::TimeRecord start_;
+    };
+
+private:
+    const bool isEnabled_;
+    llvm::TimeRecord times_[kPhaseCount];
+    unsigned long counts_[kCounterCount]{};
+    size_t arenaPeakBytes_{0};
+};
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: MPISTATISTICS_HPP_W4QJ7ZAD
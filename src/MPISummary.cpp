@@ -0,0 +1,332 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#include "MPISummary.hpp"
+#include "PointToPointMatcher.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+namespace mpi {
+
+namespace {
+
+const uint32_t kMagic{0x5355534d};  // "MSUS" read little endian
+const uint32_t kVersion{1};
+
+enum CallFlags : uint8_t { kSend = 1 << 0, kRecv = 1 << 1, kBlocking = 1 << 2 };
+
+// little endian encoding with a table of unique strings
+class SummaryWriter {
+public:
+    void writeU8(const uint8_t value) { data_.push_back(value); }
+
+    void writeU32(const uint32_t value) {
+        for (size_t i = 0; i < 4; ++i) {
+            data_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void writeString(const std::string &string) {
+        auto it = stringIndices_.find(string);
+        if (it == stringIndices_.end()) {
+            it = stringIndices_.emplace(string, strings_.size()).first;
+            strings_.push_back(&it->first);
+        }
+        writeU32(it->second);
+    }
+
+    bool save(const std::string &path) const {
+        SummaryWriter header;
+        header.writeU32(kMagic);
+        header.writeU32(kVersion);
+        header.writeU32(strings_.size());
+        for (const std::string *string : strings_) {
+            header.writeU32(string->size());
+            header.data_.insert(header.data_.end(), string->begin(),
+                                string->end());
+        }
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(header.data_.data()),
+                   header.data_.size());
+        file.write(reinterpret_cast<const char *>(data_.data()),
+                   data_.size());
+        return static_cast<bool>(file);
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    std::unordered_map<std::string, uint32_t> stringIndices_;
+    std::vector<const std::string *> strings_;
+};
+
+class SummaryReader {
+public:
+    bool load(const std::string &path) {
+        std::ifstream file{path, std::ios::binary};
+        data_.assign(std::istreambuf_iterator<char>{file},
+                     std::istreambuf_iterator<char>{});
+        if (!file.good() && !file.eof()) return false;
+
+        uint32_t magic, version, stringCount;
+        if (!readU32(magic) || magic != kMagic) return false;
+        if (!readU32(version) || version != kVersion) return false;
+        if (!readU32(stringCount)) return false;
+        for (uint32_t i = 0; i < stringCount; ++i) {
+            uint32_t size;
+            if (!readU32(size) || data_.size() - pos_ < size) return false;
+            strings_.emplace_back(data_.begin() + pos_,
+                                  data_.begin() + pos_ + size);
+            pos_ += size;
+        }
+        return true;
+    }
+
+    bool readU8(uint8_t &value) {
+        if (pos_ >= data_.size()) return false;
+        value = static_cast<uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool readU32(uint32_t &value) {
+        if (data_.size() - pos_ < 4) return false;
+        value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(
+                         static_cast<uint8_t>(data_[pos_++])) << (8 * i);
+        }
+        return true;
+    }
+
+    bool readString(std::string &string) {
+        uint32_t idx;
+        if (!readU32(idx) || idx >= strings_.size()) return false;
+        string = strings_[idx];
+        return true;
+    }
+
+    bool isAtEnd() const { return pos_ == data_.size(); }
+
+private:
+    std::vector<char> data_;
+    size_t pos_{0};
+    std::vector<std::string> strings_;
+};
+
+/**
+ * Rank cases of all summaries of a program, described for
+ * PointToPointMatcher. Reports are collected as diagnostics.
+ */
+class SummarySchema {
+public:
+    using Key = std::string;
+    using KeyHash = std::hash<std::string>;
+
+    SummarySchema(const std::vector<MPISummary> &summaries) {
+        for (const MPISummary &summary : summaries) {
+            for (const SummaryRankCase &rankCase : summary.rankCases_) {
+                rankCases_.push_back(&rankCase);
+            }
+        }
+    }
+
+    size_t caseCount() const { return rankCases_.size(); }
+    size_t callCount(const size_t rankCase) const {
+        return rankCases_[rankCase]->calls_.size();
+    }
+    bool isConditionUnambiguouslyEqual(const size_t first,
+                                       const size_t second) const {
+        return !rankCases_[first]->isAmbiguous_ &&
+               !rankCases_[second]->isAmbiguous_ &&
+               rankCases_[first]->condition_ == rankCases_[second]->condition_;
+    }
+    bool isSend(const size_t rankCase, const size_t idx) const {
+        return call(rankCase, idx).isSend_;
+    }
+    bool isRecv(const size_t rankCase, const size_t idx) const {
+        return call(rankCase, idx).isRecv_;
+    }
+    bool isBlocking(const size_t rankCase, const size_t idx) const {
+        return call(rankCase, idx).isBlocking_;
+    }
+    const std::string *matchKey(const size_t rankCase,
+                                const size_t idx) const {
+        const std::string &key = call(rankCase, idx).matchKey_;
+        return key.empty() ? nullptr : &key;
+    }
+
+    void reportUnmatchedCall(const size_t rankCase, const size_t idx) {
+        diagnostics_.push_back({call(rankCase, idx).location_,
+                                isSend(rankCase, idx)
+                                    ? "No matching receive function found."
+                                    : "No matching send function found."});
+    }
+    void reportUnreachableCall(const size_t rankCase, const size_t idx) {
+        diagnostics_.push_back(
+            {call(rankCase, idx).location_,
+             "Call is not reachable. Schema leads to a deadlock."});
+    }
+
+    std::vector<SummaryDiagnostic> diagnostics_;
+
+private:
+    const SummaryCall &call(const size_t rankCase, const size_t idx) const {
+        return rankCases_[rankCase]->calls_[idx];
+    }
+
+    std::vector<const SummaryRankCase *> rankCases_;
+};
+
+}  // end of anonymous namespace
+
+/**
+ * Writes the summary in binary format.
+ *
+ * @param path file to write
+ *
+ * @return success
+ */
+bool MPISummary::write(const std::string &path) const {
+    SummaryWriter writer;
+    writer.writeU32(rankCases_.size());
+    for (const SummaryRankCase &rankCase : rankCases_) {
+        writer.writeU8(rankCase.isAmbiguous_);
+        writer.writeString(rankCase.condition_);
+        writer.writeU32(rankCase.calls_.size());
+        for (const SummaryCall &call : rankCase.calls_) {
+            writer.writeString(call.name_);
+            writer.writeString(call.location_);
+            writer.writeString(call.matchKey_);
+            writer.writeU8((call.isSend_ ? kSend : 0) |
+                           (call.isRecv_ ? kRecv : 0) |
+                           (call.isBlocking_ ? kBlocking : 0));
+        }
+    }
+    return writer.save(path);
+}
+
+/**
+ * Reads a summary written by MPISummary::write.
+ *
+ * @param path file to read
+ *
+ * @return success, false if the file is missing, truncated
+ * or of another format version
+ */
+bool MPISummary::read(const std::string &path) {
+    rankCases_.clear();
+    SummaryReader reader;
+    if (!reader.load(path)) return false;
+
+    uint32_t caseCount;
+    if (!reader.readU32(caseCount)) return false;
+    for (uint32_t i = 0; i < caseCount; ++i) {
+        SummaryRankCase rankCase;
+        uint8_t isAmbiguous;
+        uint32_t callCount;
+        if (!reader.readU8(isAmbiguous) ||
+            !reader.readString(rankCase.condition_) ||
+            !reader.readU32(callCount)) {
+            return false;
+        }
+        rankCase.isAmbiguous_ = isAmbiguous;
+
+        for (uint32_t j = 0; j < callCount; ++j) {
+            SummaryCall call;
+            uint8_t flags;
+            if (!reader.readString(call.name_) ||
+                !reader.readString(call.location_) ||
+                !reader.readString(call.matchKey_) || !reader.readU8(flags)) {
+                return false;
+            }
+            call.isSend_ = flags & kSend;
+            call.isRecv_ = flags & kRecv;
+            call.isBlocking_ = flags & kBlocking;
+            rankCase.calls_.push_back(std::move(call));
+        }
+        rankCases_.push_back(std::move(rankCase));
+    }
+    return reader.isAtEnd();
+}
+
+/**
+ * Checks the point to point schema and reachability of calls across the
+ * rank cases of all summaries, as if they belonged to one translation unit.
+ *
+ * @param summaries of all translation units of the program
+ *
+ * @return diagnostics, sorted by location without duplicates
+ */
+std::vector<SummaryDiagnostic> mergeSummaries(
+    const std::vector<MPISummary> &summaries) {
+    SummarySchema schema{summaries};
+    PointToPointMatcher<SummarySchema> matcher{schema};
+    matcher.checkPointToPointSchema();
+    matcher.checkReachability();
+
+    auto &diagnostics = schema.diagnostics_;
+    auto isLess = [](const SummaryDiagnostic &lhs,
+                     const SummaryDiagnostic &rhs) {
+        return lhs.location_ != rhs.location_ ? lhs.location_ < rhs.location_
+                                              : lhs.message_ < rhs.message_;
+    };
+    auto isEqual = [](const SummaryDiagnostic &lhs,
+                      const SummaryDiagnostic &rhs) {
+        return lhs.location_ == rhs.location_ && lhs.message_ == rhs.message_;
+    };
+    std::sort(diagnostics.begin(), diagnostics.end(), isLess);
+    diagnostics.erase(
+        std::unique(diagnostics.begin(), diagnostics.end(), isEqual),
+        diagnostics.end());
+    return std::move(diagnostics);
+}
+
+/**
+ * Derives the summary file name from the main source file path. The path
+ * is hashed (FNV-1a) so that equally named sources of different
+ * directories get distinct summaries.
+ *
+ * @param sourcePath main source file of the translation unit
+ *
+ * @return <filename>-<hash>.mpisummary
+ */
+std::string summaryFileName(const std::string &sourcePath) {
+    uint64_t hash{0xcbf29ce484222325};
+    for (const char c : sourcePath) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+    }
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx",
+                  static_cast<unsigned long long>(hash));
+
+    const size_t separator = sourcePath.find_last_of('/');
+    const std::string filename{separator == std::string::npos
+                                   ? sourcePath
+                                   : sourcePath.substr(separator + 1)};
+    return filename + "-" + hashText + ".mpisummary";
+}
+
+}  // end of namespace: mpi
@@ -0,0 +1,76 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef MPISUMMARY_HPP_K2PN7GXB
+#define MPISUMMARY_HPP_K2PN7GXB
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// portable summaries of the point to point schema of translation units,
+// does not depend on clang so that drivers can merge them cheaply
+
+namespace mpi {
+
+// mpi call of a rank case
+struct SummaryCall {
+    std::string name_;      // mpi function name
+    std::string location_;  // file:line:column
+    // portable match key, empty if the call can not be matched
+    std::string matchKey_;
+    bool isSend_;
+    bool isRecv_;
+    bool isBlocking_;
+};
+
+struct SummaryRankCase {
+    bool isAmbiguous_;
+    // canonical matched condition, compared if both cases are unambiguous
+    std::string condition_;
+    std::vector<SummaryCall> calls_;
+};
+
+// rank cases of one translation unit
+struct MPISummary {
+    bool write(const std::string &path) const;
+    bool read(const std::string &path);
+
+    std::vector<SummaryRankCase> rankCases_;
+};
+
+struct SummaryDiagnostic {
+    std::string location_;
+    std::string message_;
+};
+
+std::vector<SummaryDiagnostic> mergeSummaries(
+    const std::vector<MPISummary> &);
+
+// file name of the summary of a main source file, stable across processes
+std::string summaryFileName(const std::string &sourcePath);
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: MPISUMMARY_HPP_K2PN7GXB
@@ -23,6 +23,7 @@
 */
 
 #include "MPITypes.hpp"
+#include "MPIArena.hpp"
 #include "Container.hpp"
 
 using namespace clang;
@@ -30,18 +31,44 @@ using namespace ento;
 
 namespace mpi {
 
-unsigned long MPICall::idCounter{0};
+/**
+ * Captures an mpi call. Arguments are not parsed until they are requested.
+ *
+ * @param callExpr mpi call captured
+ * @param id unique call identification
+ * @param arena arguments are allocated in
+ * @param canonicalForms table arguments are interned in
+ */
+MPICall::MPICall(const CallExpr *const callExpr, const unsigned long id,
+                 MPIArena &arena, CanonicalFormTable &canonicalForms)
+    : callExpr_{callExpr},
+      arena_{arena},
+      canonicalForms_{canonicalForms},
+      arguments_{arena.allocateArray<const ArgumentVisitor *>(
+          callExpr->getNumArgs())},
+      identInfo_{callExpr->getDirectCallee()->getIdentifier()},
+      id_{id} {}
 
-namespace MPIRank {
-llvm::SmallSet<const VarDecl *, 4> visitedRankVariables;
+/**
+ * Returns the argument at given index, parsed on first request.
+ *
+ * @param idx argument index
+ *
+ * @return parsed argument
+ */
+const ArgumentVisitor &MPICall::argument(const size_t idx) const {
+    assert(idx < argumentCount() && "argument index out of range");
+    if (!arguments_[idx]) {
+        arguments_[idx] =
+            arena_.createStatement(callExpr_->getArg(idx), canonicalForms_);
+    }
+    return *arguments_[idx];
 }
 
-llvm::SmallVector<MPIRankCase, 8> MPIRankCase::visitedRankCases;
-
 bool MPICall::operator==(const MPICall &callToCompare) const {
-    if (arguments_.size() != callToCompare.arguments_.size()) return false;
-    for (size_t i = 0; i < arguments_.size(); ++i) {
-        if (!arguments_[i].isEqual(callToCompare.arguments_[i])) {
+    if (argumentCount() != callToCompare.argumentCount()) return false;
+    for (size_t i = 0; i < argumentCount(); ++i) {
+        if (!argument(i).isEqual(callToCompare.argument(i))) {
             return false;
         }
     }
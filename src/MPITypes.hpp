@@ -25,10 +25,9 @@
 #ifndef MPITYPES_HPP_IC7XR2MI
 #define MPITYPES_HPP_IC7XR2MI
 
-#include "llvm/ADT/SmallSet.h"
 #include "StatementVisitor.hpp"
-#include "CallExprVisitor.hpp"
 #include "MPIFunctionClassifier.hpp"
+#include <algorithm>
 
 // types modeling mpi function calls and variables –––––––––––––––––––––
 
@@ -40,11 +39,14 @@ namespace MPIPointToPoint {
 enum { kBuf, kCount, kDatatype, kRank, kTag, kComm, kRequest };
 }
 
+class MPIArena;
+
+// immutable description of a call, shared by all checks
 struct MPICall {
 public:
-    MPICall(const clang::CallExpr *const callExpr) : callExpr_{callExpr} {
-        init(callExpr);
-    };
+    // arguments are parsed on demand and allocated in the arena
+    MPICall(const clang::CallExpr *const, const unsigned long id, MPIArena &,
+            CanonicalFormTable &);
 
     bool operator==(const MPICall &) const;
     bool operator!=(const MPICall &) const;
@@ -53,115 +55,153 @@ public:
     operator const clang::IdentifierInfo *() const { return identInfo_; }
 
     const clang::CallExpr *callExpr() const { return callExpr_; }
-    const std::vector<ArgumentVisitor> &arguments() const { return arguments_; }
+    const ArgumentVisitor &argument(const size_t) const;
+    size_t argumentCount() const { return callExpr_->getNumArgs(); }
     const clang::IdentifierInfo *identInfo() const { return identInfo_; }
     unsigned long id() const { return id_; };  // unique call identification
 
-    // marking can be changed freely by clients
-    // semantic depends on context of usage
-    mutable bool isMarked_{false};
-    mutable bool isReachable_{false};
-
 private:
-    /**
-     * Init function shared by ctors.
-     * @param callExpr mpi call captured
-     */
-    void init(const clang::CallExpr *const callExpr) {
-        const clang::FunctionDecl *functionDeclNew =
-            callExpr_->getDirectCallee();
-        identInfo_ = functionDeclNew->getIdentifier();
-        // build argument vector
-        for (size_t i = 0; i < callExpr->getNumArgs(); ++i) {
-            // emplace triggers ArgumentVisitor ctor
-            arguments_.emplace_back(callExpr->getArg(i));
-        }
-    }
-
     const clang::CallExpr *callExpr_;
-    std::vector<ArgumentVisitor> arguments_;
+    MPIArena &arena_;
+    CanonicalFormTable &canonicalForms_;
+    // parsed arguments by index, nullptr until requested
+    const ArgumentVisitor **arguments_;
     const clang::IdentifierInfo *identInfo_;
-    unsigned long id_{idCounter++};  // unique call identification
-
-    static unsigned long idCounter;
+    const unsigned long id_;  // unique call identification
 };
 
-// to capture rank variables
-namespace MPIRank {
-extern llvm::SmallSet<const clang::VarDecl *, 4> visitedRankVariables;
-}
+// mpi call as part of a rank case
+struct RankCaseCall {
+    // implicit conversion function
+    operator const clang::IdentifierInfo *() const {
+        return mpiCall_->identInfo();
+    }
+    const clang::CallExpr *callExpr() const { return mpiCall_->callExpr(); }
+
+    const MPICall *mpiCall_;
+    // marking can be changed freely by clients
+    // semantic depends on context of usage
+    bool isMarked_;
+};
 
 // to capture rank cases from branches
 class MPIRankCase {
 public:
-    MPIRankCase(const clang::Stmt *const then,
-                const clang::Stmt *const matchedCondition,
-                const std::vector<ConditionVisitor> &unmatchedConditions,
-                const MPIFunctionClassifier &funcClassifier)
-
-        : unmatchedConditions_{unmatchedConditions} {
-        if (matchedCondition) {
-            matchedCondition_.reset(new ConditionVisitor{matchedCondition});
-        }
-
-        const CallExprVisitor callExprVisitor{then};  // collect call exprs
-        for (const clang::CallExpr *const callExpr :
-             callExprVisitor.callExprs()) {
-            // add mpi calls only
-            if (funcClassifier.isMPIType(
-                    callExpr->getDirectCallee()->getIdentifier())) {
-                mpiCalls_.push_back(callExpr);
-            }
-        }
-    }
-
-    static void unmarkCalls() {
-        for (MPIRankCase &rankCase : MPIRankCase::visitedRankCases) {
-            for (MPICall &call : rankCase.mpiCalls_) {
-                call.isMarked_ = false;
-            }
-        }
+    // conditions are expected to outlive the rank case
+    MPIRankCase(
+        const ConditionVisitor *const matchedCondition,
+        llvm::ArrayRef<const ConditionVisitor *> unmatchedConditions,
+        const clang::FunctionDecl *const functionDecl)
+
+        : unmatchedConditions_{unmatchedConditions},
+          functionDecl_{functionDecl},
+          matchedCondition_{matchedCondition} {}
+
+    // mpi calls must be added in the order they appear in the case
+    void addCall(const MPICall *const mpiCall) {
+        mpiCalls_.push_back({mpiCall, false});
     }
 
     bool isConditionAmbiguous() const;
     bool isConditionUnambiguouslyEqual(const MPIRankCase &) const;
     size_t size() const { return mpiCalls_.size(); }
-    const std::vector<MPICall> &mpiCalls() const { return mpiCalls_; }
-    const std::unique_ptr<ConditionVisitor> &matchedCondition() const {
+    std::vector<RankCaseCall> &mpiCalls() { return mpiCalls_; }
+    const std::vector<RankCaseCall> &mpiCalls() const { return mpiCalls_; }
+    const ConditionVisitor *matchedCondition() const {
         return matchedCondition_;
     }
+    // function the rank case is contained in
+    const clang::FunctionDecl *functionDecl() const { return functionDecl_; }
 
     // conditions not fullfilled to enter rank case
-    const std::vector<ConditionVisitor> unmatchedConditions_;
-    static llvm::SmallVector<MPIRankCase, 8> visitedRankCases;
+    const llvm::ArrayRef<const ConditionVisitor *> unmatchedConditions_;
 
 private:
-    std::vector<MPICall> mpiCalls_;
-    // condition fulfilled to enter rank case
-    std::unique_ptr<ConditionVisitor> matchedCondition_{nullptr};
+    std::vector<RankCaseCall> mpiCalls_;
+    const clang::FunctionDecl *functionDecl_;
+    // condition fulfilled to enter rank case, nullptr for else
+    const ConditionVisitor *matchedCondition_;
 };
 
 // for path sensitive analysis–––––––––––––––––––––––––––––––––––––––––––––––
+// state a request was left in by the last call using it
+enum class RequestState : unsigned char {
+    kNonblocking,  // in use by a nonblocking call
+    kWaited,       // completed by a wait
+    kCompleted,    // completed by a test or MPI_Waitsome, may be waited on
+    kFreed         // released by MPI_Request_free
+};
+
+// The call that last used a request is not stored, so that states of
+// paths reaching a request through different calls can be merged. It is
+// recovered from the exploded graph when a report needs it.
 struct RequestVar {
-    RequestVar(const clang::VarDecl *const varDecl,
-               const clang::CallExpr *const callExpr)
-        : varDecl_{varDecl}, lastUser_{callExpr} {}
+    RequestVar(const clang::ento::MemRegion *const region,
+               const RequestState state)
+        : region_{region}, state_{state} {}
 
     void Profile(llvm::FoldingSetNodeID &id) const {
-        id.AddPointer(varDecl_);
-        id.AddPointer(lastUser_);
+        id.AddPointer(region_);
+        id.AddInteger(static_cast<unsigned>(state_));
     }
 
     bool operator==(const RequestVar &toCompare) const {
-        return toCompare.varDecl_ == varDecl_;
+        return toCompare.region_ == region_ && toCompare.state_ == state_;
+    }
+
+    // variable or array element holding the request
+    const clang::ento::MemRegion *const region_;
+    const RequestState state_;
+};
+
+// Summary of the requests of an array posted at indices unknown to the
+// analysis, e.g. by a nonblocking call on &requests[i] in a loop. Counts
+// only depend on the current batch of requests, so that states of
+// consecutive loop iterations are equal and can be merged.
+struct RequestArray {
+    RequestArray() : inFlight_{0}, waited_{0} {}
+    RequestArray(const unsigned inFlight, const unsigned waited)
+        : inFlight_{inFlight}, waited_{waited} {}
+
+    // requests posted while none is in flight start a new batch
+    RequestArray posted(const unsigned count = 1) const {
+        return {inFlight_ + count, inFlight_ ? waited_ : 0};
+    }
+    RequestArray completed(unsigned count) const {
+        count = std::min(count, inFlight_);
+        return {inFlight_ - count, waited_ + count};
+    }
+
+    void Profile(llvm::FoldingSetNodeID &id) const {
+        id.AddInteger(inFlight_);
+        id.AddInteger(waited_);
+    }
+
+    bool operator==(const RequestArray &toCompare) const {
+        return toCompare.inFlight_ == inFlight_ &&
+               toCompare.waited_ == waited_;
     }
 
-    const clang::VarDecl *const varDecl_;
-    const clang::CallExpr *const lastUser_;
+    const unsigned inFlight_;  // in use by nonblocking calls
+    const unsigned waited_;    // completed by waits
 };
 }  // end of namespace: mpi
 
-// register data structure for path sensitive analysis
-REGISTER_MAP_WITH_PROGRAMSTATE(RequestVarMap, clang::VarDecl *, mpi::RequestVar)
+// register data structures for path sensitive analysis
+// requests by variable or array element region
+REGISTER_MAP_WITH_PROGRAMSTATE(RequestVarMap, const clang::ento::MemRegion *,
+                               mpi::RequestVar)
+// request array summaries by array region
+REGISTER_MAP_WITH_PROGRAMSTATE(RequestArrayMap,
+                               const clang::ento::MemRegion *,
+                               mpi::RequestArray)
+// handles of requests whose region died while a copy of the handle is
+// still live, by request region
+REGISTER_MAP_WITH_PROGRAMSTATE(RequestHandleMap,
+                               const clang::ento::MemRegion *,
+                               clang::ento::SymbolRef)
+// outcome of a test call assumed by a state, from the pre to the post
+// statement callback of the call
+REGISTER_MAP_WITH_PROGRAMSTATE(TestOutcomeMap, const clang::CallExpr *, bool)
 
 #endif  // end of include guard: MPITYPES_HPP_IC7XR2MI
@@ -0,0 +1,317 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#ifndef POINTTOPOINTMATCHER_HPP_V6JX3NQA
+#define POINTTOPOINTMATCHER_HPP_V6JX3NQA
+
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mpi {
+
+/**
+ * Matches point to point calls of rank cases and checks if they can be
+ * reached. Shared by the checks of a translation unit and the merge of
+ * summaries, so that both come to the same result. Does not depend on
+ * clang.
+ *
+ * Rank cases and their calls are referred to by index. The schema
+ * describing them provides:
+ * - Key, KeyHash: type of the match keys and their hash
+ * - caseCount(), callCount(rankCase)
+ * - isConditionUnambiguouslyEqual(rankCase, rankCase)
+ * - isSend(rankCase, call), isRecv(rankCase, call),
+ *   isBlocking(rankCase, call)
+ * - matchKey(rankCase, call): pointer to the key, nullptr if the call
+ *   can not be matched
+ * - reportUnmatchedCall(rankCase, call),
+ *   reportUnreachableCall(rankCase, call)
+ *
+ * @tparam Schema
+ */
+template <typename Schema>
+class PointToPointMatcher {
+public:
+    explicit PointToPointMatcher(Schema &schema) : schema_{schema} {}
+
+    void checkPointToPointSchema();
+    void checkReachability();
+    // send/recv pairs compared while checking reachability
+    unsigned long pairChecks() const { return pairChecks_; }
+
+private:
+    using Key = typename Schema::Key;
+    struct CallMarks {
+        bool isMarked_{false};
+        bool isReachable_{false};
+    };
+    // receives of one rank case sharing a match key, in call order
+    struct RecvBucket {
+        std::vector<size_t> recvs_;
+        size_t firstUnmarked_{0};
+    };
+    using RecvIndex =
+        std::unordered_map<Key, RecvBucket, typename Schema::KeyHash>;
+
+    void resetMarks();
+    bool isPartner(const size_t, const size_t) const;
+    void checkSendRecvMatches(const size_t, const size_t, RecvIndex &);
+    bool checkReachabilityPair(const size_t, const size_t);
+    bool isSendRecvPair(const size_t, const size_t, const size_t,
+                        const size_t);
+
+    Schema &schema_;
+    std::vector<std::vector<CallMarks>> marks_;
+    unsigned long pairChecks_{0};
+};
+
+/**
+ * Resets the marks of all calls.
+ */
+template <typename Schema>
+void PointToPointMatcher<Schema>::resetMarks() {
+    marks_.assign(schema_.caseCount(), {});
+    for (size_t i = 0; i < marks_.size(); ++i) {
+        marks_[i].resize(schema_.callCount(i));
+    }
+}
+
+/**
+ * Rank conditions must be distinct or ambiguous for cases to interact.
+ *
+ * @param first rank case
+ * @param second rank case
+ *
+ * @return if the cases are potential partners
+ */
+template <typename Schema>
+bool PointToPointMatcher<Schema>::isPartner(const size_t first,
+                                            const size_t second) const {
+    return !schema_.isConditionUnambiguouslyEqual(first, second);
+}
+
+/**
+ * Checks if point to point functions resolve to a valid schema.
+ * Reports unmatched sends and receives.
+ */
+template <typename Schema>
+void PointToPointMatcher<Schema>::checkPointToPointSchema() {
+    resetMarks();
+    const size_t caseCount{schema_.caseCount()};
+
+    // index receives of each rank case by match key
+    std::vector<RecvIndex> recvIndices(caseCount);
+    for (size_t i = 0; i < caseCount; ++i) {
+        for (size_t j = 0; j < schema_.callCount(i); ++j) {
+            if (!schema_.isRecv(i, j)) continue;
+            if (const Key *const key = schema_.matchKey(i, j)) {
+                recvIndices[i][*key].recvs_.push_back(j);
+            }
+        }
+    }
+
+    // search send/recv pairs for interacting cases
+    for (size_t first = 0; first < caseCount; ++first) {
+        for (size_t second = 0; second < caseCount; ++second) {
+            if (isPartner(first, second)) {
+                checkSendRecvMatches(first, second, recvIndices[second]);
+            }
+        }
+    }
+
+    // trigger report for unmarked
+    for (size_t i = 0; i < caseCount; ++i) {
+        for (size_t j = 0; j < schema_.callCount(i); ++j) {
+            if ((schema_.isSend(i, j) || schema_.isRecv(i, j)) &&
+                !marks_[i][j].isMarked_) {
+                schema_.reportUnmatchedCall(i, j);
+            }
+        }
+    }
+}
+
+/**
+ * Matches send with recv operations between two rank cases.
+ * Send operations of the first case are matched with the first
+ * unmarked recv operation of the second case sharing their match key.
+ * In case of a match calls are marked.
+ *
+ * @param first rank case
+ * @param second rank case
+ * @param recvIndex receives of the second case by match key
+ */
+template <typename Schema>
+void PointToPointMatcher<Schema>::checkSendRecvMatches(const size_t first,
+                                                       const size_t second,
+                                                       RecvIndex &recvIndex) {
+    for (size_t j = 0; j < schema_.callCount(first); ++j) {
+        if (!schema_.isSend(first, j) || marks_[first][j].isMarked_) continue;
+
+        const Key *const key = schema_.matchKey(first, j);
+        if (!key) continue;
+        auto bucket = recvIndex.find(*key);
+        if (bucket == recvIndex.end()) continue;
+
+        // marks are never removed while matching,
+        // so skipped receives need not be looked at again
+        const auto &recvs = bucket->second.recvs_;
+        size_t &idx = bucket->second.firstUnmarked_;
+        while (idx < recvs.size() && marks_[second][recvs[idx]].isMarked_) {
+            ++idx;
+        }
+        if (idx < recvs.size()) {
+            marks_[first][j].isMarked_ = true;
+            marks_[second][recvs[idx]].isMarked_ = true;
+        }
+    }
+}
+
+/**
+ * Check if mpi calls can be reached, iterating until no further calls
+ * get matched. Reports unreachable calls.
+ */
+template <typename Schema>
+void PointToPointMatcher<Schema>::checkReachability() {
+    resetMarks();
+    const size_t caseCount{schema_.caseCount()};
+
+    std::vector<std::vector<size_t>> partners(caseCount);
+    for (size_t i = 0; i < caseCount; ++i) {
+        for (size_t j = 0; j < caseCount; ++j) {
+            if (isPartner(i, j)) partners[i].push_back(j);
+        }
+    }
+
+    // case pairs waiting to be examined
+    std::deque<std::pair<size_t, size_t>> worklist;
+    std::vector<bool> isQueued(caseCount * caseCount, false);
+    auto enqueue = [&](const size_t first, const size_t second) {
+        if (!isQueued[first * caseCount + second]) {
+            isQueued[first * caseCount + second] = true;
+            worklist.emplace_back(first, second);
+        }
+    };
+    for (size_t i = 0; i < caseCount; ++i) {
+        for (const size_t j : partners[i]) enqueue(i, j);
+    }
+
+    // multiple send/recv phases per rank case are allowed,
+    // iterate until no further calls get matched
+    while (!worklist.empty()) {
+        const auto pair = worklist.front();
+        worklist.pop_front();
+        isQueued[pair.first * caseCount + pair.second] = false;
+
+        if (checkReachabilityPair(pair.first, pair.second)) {
+            // new matches can unblock calls in all pairs of both cases
+            for (const size_t rankCase : {pair.first, pair.second}) {
+                for (const size_t partner : partners[rankCase]) {
+                    enqueue(rankCase, partner);
+                    enqueue(partner, rankCase);
+                }
+            }
+        }
+    }
+
+    // trigger report for unreached
+    for (size_t i = 0; i < caseCount; ++i) {
+        for (size_t j = 0; j < schema_.callCount(i); ++j) {
+            if (!marks_[i][j].isReachable_) {
+                schema_.reportUnreachableCall(i, j);
+            }
+        }
+    }
+}
+
+/**
+ * Check for reachability of calls between two cases.
+ *
+ * @param first rank case
+ * @param second rank case
+ *
+ * @return if new send/recv pairs were matched
+ */
+template <typename Schema>
+bool PointToPointMatcher<Schema>::checkReachabilityPair(const size_t first,
+                                                        const size_t second) {
+    bool isMatched{false};
+    for (size_t i = 0; i < schema_.callCount(first); ++i) {
+        CallMarks &send = marks_[first][i];
+        send.isReachable_ = true;
+        if (send.isMarked_) continue;
+
+        for (size_t j = 0; j < schema_.callCount(second); ++j) {
+            CallMarks &recv = marks_[second][j];
+            recv.isReachable_ = true;
+            if (recv.isMarked_) continue;
+
+            // check if pair matches
+            if (isSendRecvPair(first, i, second, j)) {
+                send.isMarked_ = true;
+                recv.isMarked_ = true;
+                isMatched = true;
+                break;
+            }
+            // no match and call was blocking
+            else if (schema_.isBlocking(second, j)) {
+                break;
+            }
+        }
+
+        // no matching recv found in second case
+        if (schema_.isBlocking(first, i) && !send.isMarked_) break;
+    }
+    return isMatched;
+}
+
+/**
+ * Check if two calls are a send/recv pair.
+ *
+ * @param sendCase rank case of the send
+ * @param send call index
+ * @param recvCase rank case of the receive
+ * @param recv call index
+ *
+ * @return if they are send/recv pair
+ */
+template <typename Schema>
+bool PointToPointMatcher<Schema>::isSendRecvPair(const size_t sendCase,
+                                                 const size_t send,
+                                                 const size_t recvCase,
+                                                 const size_t recv) {
+    ++pairChecks_;
+    if (!schema_.isSend(sendCase, send)) return false;
+    if (!schema_.isRecv(recvCase, recv)) return false;
+
+    const Key *const sendKey = schema_.matchKey(sendCase, send);
+    const Key *const recvKey = schema_.matchKey(recvCase, recv);
+    return sendKey && recvKey && *sendKey == *recvKey;
+}
+
+}  // end of namespace: mpi
+
+#endif  // end of include guard: POINTTOPOINTMATCHER_HPP_V6JX3NQA
@@ -24,8 +24,7 @@
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
 #include "StatementVisitor.hpp"
-#include "Container.hpp"
-#include "Utility.hpp"
+#include "llvm/Support/MathExtras.h"
 
 using namespace clang;
 using namespace ento;
@@ -44,13 +43,11 @@ bool StatementVisitor::VisitDeclRefExpr(clang::DeclRefExpr *declRef) {
     if (clang::VarDecl *var =
             clang::dyn_cast<clang::VarDecl>(declRef->getDecl())) {
         vars_.push_back(var);
-        typeSequence_.push_back(ComponentType::kVar);
-        valueSequence_.push_back(var->getNameAsString());
+        addComponent(ComponentType::kVar, var->getIdentifier(), 0);
     } else if (clang::FunctionDecl *fn =
                    clang::dyn_cast<clang::FunctionDecl>(declRef->getDecl())) {
         functions_.push_back(fn);
-        typeSequence_.push_back(ComponentType::kFunc);
-        valueSequence_.push_back(fn->getNameAsString());
+        addComponent(ComponentType::kFunc, fn->getIdentifier(), 0);
     }
     return true;
 }
@@ -64,17 +61,15 @@ bool StatementVisitor::VisitDeclRefExpr(clang::DeclRefExpr *declRef) {
  */
 bool StatementVisitor::VisitBinaryOperator(clang::BinaryOperator *op) {
     binaryOperators_.push_back(op->getOpcode());
+    ComponentType type{ComponentType::kOperator};
     if (op->isComparisonOp()) {
-        typeSequence_.push_back(ComponentType::kComparsison);
+        type = ComponentType::kComparsison;
     } else if (op->getOpcode() == BinaryOperatorKind::BO_Add) {
-        typeSequence_.push_back(ComponentType::kAddOp);
+        type = ComponentType::kAddOp;
     } else if (op->getOpcode() == BinaryOperatorKind::BO_Sub) {
-        typeSequence_.push_back(ComponentType::kSubOp);
-    } else {
-        typeSequence_.push_back(ComponentType::kOperator);
+        type = ComponentType::kSubOp;
     }
-
-    valueSequence_.push_back(op->getOpcodeStr());
+    addComponent(type, nullptr, op->getOpcode());
 
     return true;
 }
@@ -88,15 +83,8 @@ bool StatementVisitor::VisitBinaryOperator(clang::BinaryOperator *op) {
  */
 bool StatementVisitor::VisitIntegerLiteral(IntegerLiteral *intLiteral) {
     integerLiterals_.push_back(intLiteral);
-    typeSequence_.push_back(ComponentType::kInt);
-
-    SmallVector<char, 4> intValAsString;
-    intLiteral->getValue().toStringUnsigned(intValAsString);
-    std::string val;
-    for (char c : intValAsString) {
-        val.push_back(c);
-    }
-    valueSequence_.push_back(val);
+    addComponent(ComponentType::kInt, nullptr,
+                 intLiteral->getValue().getLimitedValue());
     return true;
 }
 
@@ -109,62 +97,23 @@ bool StatementVisitor::VisitIntegerLiteral(IntegerLiteral *intLiteral) {
  */
 bool StatementVisitor::VisitFloatingLiteral(FloatingLiteral *floatLiteral) {
     floatingLiterals_.push_back(floatLiteral);
-    typeSequence_.push_back(ComponentType::kFloat);
-
-    valueSequence_.push_back(
-        std::to_string(floatLiteral->getValueAsApproximateDouble()));
+    addComponent(
+        ComponentType::kFloat, nullptr,
+        llvm::DoubleToBits(floatLiteral->getValueAsApproximateDouble()));
     return true;
 }
 
 /**
  * Check if components of statement are equal to compared visitor.
- * Chosen equality comparison depends on operator commutativity.
- *
- * @param visitorToCompare
- *
- * @return continue visiting
- */
-bool StatementVisitor::isEqual(const StatementVisitor &visitorToCompare) const {
-    if (containsSubtraction() || visitorToCompare.containsSubtraction()) {
-        return isEqualOrdered(visitorToCompare);
-    } else {
-        return isEqualPermutative(visitorToCompare);
-    }
-}
-
-/**
- * Compare operators and operands as ordered sequence.
- *
- * @param visitorToCompare
- *
- * @return equality
- */
-bool StatementVisitor::isEqualOrdered(
-    const StatementVisitor &visitorToCompare) const {
-    if (typeSequence_ != visitorToCompare.typeSequence_) return false;
-    if (valueSequence_ != visitorToCompare.valueSequence_) return false;
-
-    return true;
-}
-
-/**
- * Compare operators and operands as permutation.
+ * Operands are compared as permutation unless a subtraction is involved,
+ * which the canonical form already accounts for.
  *
  * @param visitorToCompare
  *
  * @return equality
  */
-bool StatementVisitor::isEqualPermutative(
-    const StatementVisitor &visitorToCompare) const {
-    // type sequence must be permutation
-    if (!cont::isPermutation(typeSequence_, visitorToCompare.typeSequence_)) {
-        return false;
-    }
-    if (!cont::isPermutation(valueSequence_, visitorToCompare.valueSequence_)) {
-        return false;
-    }
-
-    return true;
+bool StatementVisitor::isEqual(const StatementVisitor &visitorToCompare) const {
+    return canonicalForm_ == visitorToCompare.canonicalForm_;
 }
 
 /**
@@ -181,6 +130,19 @@ bool StatementVisitor::containsSubtraction() const {
     return false;
 }
 
+/**
+ * Appends a component to the sequence.
+ *
+ * @param type
+ * @param identity identifier of variables and functions
+ * @param value literal value or operator code
+ */
+void StatementVisitor::addComponent(const ComponentType type,
+                                    const void *const identity,
+                                    const uint64_t value) {
+    components_.push_back(StatementComponent{type, identity, value});
+}
+
 /**
  * Check if the last operator is "inverse".
  *
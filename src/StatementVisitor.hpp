@@ -26,30 +26,27 @@
 #define STATEMENTVISITOR_HPP_9UDA2XCC
 
 #include "clang/AST/RecursiveASTVisitor.h"
+#include "CanonicalForm.hpp"
 
 namespace mpi {
 
 /**
  * Visitor class to traverse a statement.
  * On the way it collects binary operators, variable decls, function decls,
- * integer literals, floating literals.
+ * integer literals, floating literals. The collected component sequence is
+ * interned in a canonical form table, so that statements can be compared
+ * by pointer.
  */
 class StatementVisitor : public clang::RecursiveASTVisitor<StatementVisitor> {
 public:
-    StatementVisitor(const clang::Stmt *const stmt) : stmt_{stmt} {
+    StatementVisitor(const clang::Stmt *const stmt,
+                     CanonicalFormTable &canonicalForms)
+        : stmt_{stmt} {
         TraverseStmt(const_cast<clang::Stmt *>(stmt_));
+        canonicalForm_ = canonicalForms.get(components_, containsSubtraction());
     }
 
-    enum class ComponentType {
-        kInt,
-        kFloat,
-        kVar,
-        kFunc,
-        kComparsison,
-        kAddOp,
-        kSubOp,
-        kOperator
-    };
+    using ComponentType = mpi::ComponentType;
 
     // must be public to trigger callbacks
     bool VisitDeclRefExpr(clang::DeclRefExpr *);
@@ -59,16 +56,17 @@ public:
 
     // non visitor functions
     bool isEqual(const StatementVisitor &) const;
-    bool isEqualOrdered(const StatementVisitor &) const;
-    bool isEqualPermutative(const StatementVisitor &) const;
     bool containsSubtraction() const;
     bool isLastOperatorInverse(const StatementVisitor &) const;
 
     // getters –––––––––––––––––––––––––––––––––––––––––––––
-    const llvm::SmallVectorImpl<ComponentType> &typeSequence() const {
-        return typeSequence_;
+    // components in traversal order
+    llvm::ArrayRef<StatementComponent> components() const {
+        return components_;
     }
 
+    const CanonicalForm *canonicalForm() const { return canonicalForm_; }
+
     const llvm::SmallVectorImpl<clang::BinaryOperatorKind> &binaryOperators()
         const {
         return binaryOperators_;
@@ -92,18 +90,16 @@ public:
         return floatingLiterals_;
     }
 
-    const llvm::SmallVectorImpl<std::string> &valueSequence() const {
-        return valueSequence_;
-    }
-
     // complete statement
     const clang::Stmt *const stmt_;
 
 private:
-    // sequential series of types
-    llvm::SmallVector<ComponentType, 4> typeSequence_;
-    // sequential series of values
-    llvm::SmallVector<std::string, 4> valueSequence_;
+    void addComponent(const ComponentType, const void *const,
+                      const uint64_t);
+
+    // sequential series of components
+    llvm::SmallVector<StatementComponent, 4> components_;
+    const CanonicalForm *canonicalForm_{nullptr};
     // components
     llvm::SmallVector<clang::BinaryOperatorKind, 1> binaryOperators_;
     llvm::SmallVector<clang::VarDecl *, 1> vars_;
@@ -42,45 +42,86 @@ bool TranslationUnitVisitor::VisitFunctionDecl(FunctionDecl *functionDecl) {
     if (functionDecl->clang::Decl::hasBody() && !functionDecl->isInlined()) {
         // to make display of function in diagnostics available
         checkerAST_.setCurrentlyVisitedFunction(functionDecl);
+        currentFunctionDecl_ = functionDecl;
     }
     return true;
 }
 
 /**
- * Visits rankCases. Checks if a rank variable is involved.
+ * Traverses a declaration. For function declarations of any kind (also
+ * methods, constructors and function templates) the range of call events
+ * of their definition is recorded for function summaries.
+ *
+ * @param decl
+ *
+ * @return continue visiting
+ */
+bool TranslationUnitVisitor::TraverseDecl(Decl *decl) {
+    const FunctionDecl *const functionDecl =
+        dyn_cast_or_null<FunctionDecl>(decl);
+    const size_t firstEvent = callEvents_.size();
+    if (!RecursiveASTVisitor<TranslationUnitVisitor>::TraverseDecl(decl)) {
+        return false;
+    }
+    if (functionDecl && functionDecl->isThisDeclarationADefinition()) {
+        functionEvents_[functionDecl] = {firstEvent, callEvents_.size()};
+    }
+    return true;
+}
+
+/**
+ * Traverses an if statement, recording its condition variables
+ * and the branches so that calls can be attributed to them.
  * Visits all if and else if!
  *
  * @param ifStmt
  *
  * @return continue visiting
  */
-bool TranslationUnitVisitor::VisitIfStmt(IfStmt *ifStmt) {
-    if (!isRankBranch(ifStmt)) return true;  // only inspect rank branches
-    if (cont::isContained(visitedIfStmts_, ifStmt)) return true;
-
-    std::vector<ConditionVisitor> unmatchedConditions;
-
-    // collect mpi calls in if / else if
-    Stmt *stmt = ifStmt;
-    while (IfStmt *ifStmt = dyn_cast_or_null<IfStmt>(stmt)) {
-        MPIRankCase::visitedRankCases.emplace_back(
-            ifStmt->getThen(), ifStmt->getCond(), unmatchedConditions,
-            checkerAST_.funcClassifier());
-        unmatchedConditions.push_back(ifStmt->getCond());
-        stmt = ifStmt->getElse();
-        visitedIfStmts_.push_back(ifStmt);
-        checkerAST_.checkForCollectiveCalls(
-            MPIRankCase::visitedRankCases.back());
-    }
+bool TranslationUnitVisitor::TraverseIfStmt(IfStmt *ifStmt) {
+    if (!WalkUpFromIfStmt(ifStmt)) return false;
+
+    const size_t ifStmtIdx = ifStmts_.size();
+    const size_t thenBranch = branches_.size();
+    branches_.push_back({currentBranch_});
+    branches_.push_back({currentBranch_});
+    ifStmts_.push_back(
+        {ifStmt, currentFunctionDecl_, thenBranch, thenBranch + 1, {}});
+    ifStmtIndices_[ifStmt] = ifStmtIdx;
 
-    // collect mpi calls in else
-    if (stmt) {
-        MPIRankCase::visitedRankCases.emplace_back(
-            stmt, nullptr, unmatchedConditions, checkerAST_.funcClassifier());
-        checkerAST_.checkForCollectiveCalls(
-            MPIRankCase::visitedRankCases.back());
+    // collect condition variables
+    const size_t enclosingCondition = currentCondition_;
+    currentCondition_ = ifStmtIdx;
+    if (!TraverseDecl(ifStmt->getConditionVariable()) ||
+        !TraverseStmt(ifStmt->getCond())) {
+        return false;
     }
+    currentCondition_ = enclosingCondition;
+
+    // traverse branches
+    const size_t enclosingBranch = currentBranch_;
+    currentBranch_ = thenBranch;
+    if (!TraverseStmt(ifStmt->getThen())) return false;
+    currentBranch_ = thenBranch + 1;
+    if (!TraverseStmt(ifStmt->getElse())) return false;
+    currentBranch_ = enclosingBranch;
+
+    return true;
+}
+
+/**
+ * Collects variables referenced in if conditions.
+ *
+ * @param declRef
+ *
+ * @return continue visiting
+ */
+bool TranslationUnitVisitor::VisitDeclRefExpr(DeclRefExpr *declRef) {
+    if (currentCondition_ == kNone) return true;
 
+    if (const VarDecl *var = dyn_cast<VarDecl>(declRef->getDecl())) {
+        ifStmts_[currentCondition_].conditionVars_.push_back(var);
+    }
     return true;
 }
 
@@ -93,35 +134,186 @@ bool TranslationUnitVisitor::VisitIfStmt(IfStmt *ifStmt) {
  */
 bool TranslationUnitVisitor::VisitCallExpr(CallExpr *callExpr) {
     const FunctionDecl *functionDecl = callExpr->getDirectCallee();
+    if (!functionDecl) return true;
 
     if (checkerAST_.funcClassifier().isMPIType(functionDecl->getIdentifier())) {
-        MPICall mpiCall{callExpr};
+        const MPICall &mpiCall = sharedContext_.mpiCall(callExpr);
+
+        // collect rank variables
+        if (checkerAST_.funcClassifier().isMPI_Comm_rank(mpiCall)) {
+            analysisContext_.rankVariables().insert(
+                mpiCall.argument(1).vars()[0]);
+        }
 
         checkerAST_.checkBufferTypeMatch(mpiCall);
         checkerAST_.checkForInvalidArgs(mpiCall);
+
+        callEvents_.push_back({&mpiCall, nullptr, currentBranch_});
+    } else {
+        // mpi calls of the callee are spliced in when rank cases are built
+        const FunctionDecl *definition{nullptr};
+        if (functionDecl->isDefined(definition)) {
+            callEvents_.push_back({nullptr, definition, currentBranch_});
+        }
     }
 
     return true;
 }
 
 /**
- * Checks if a rank variable is used in branch condition.
+ * Builds rank cases from the recorded if statements and calls.
+ * Must be called after the translation unit was traversed, when
+ * all rank variables are known.
+ */
+void TranslationUnitVisitor::collectRankCases() {
+    // rank case index for each branch
+    rankCaseForBranch_.assign(branches_.size(), kNone);
+    llvm::SmallPtrSet<const IfStmt *, 16> visitedIfStmts;
+
+    for (const IfStmtEntry &entry : ifStmts_) {
+        // only inspect rank branches
+        if (!isRankBranch(entry)) continue;
+        if (visitedIfStmts.count(entry.ifStmt_)) continue;
+
+        std::vector<const ConditionVisitor *> unmatchedConditions;
+
+        // rank cases for if / else if
+        const IfStmtEntry *chainEntry = &entry;
+        while (true) {
+            const IfStmt *ifStmt = chainEntry->ifStmt_;
+            // shared by the case and the following ones of the chain
+            const ConditionVisitor *condition =
+                arena_.createStatement(ifStmt->getCond(), canonicalForms_);
+            rankCaseForBranch_[chainEntry->thenBranch_] =
+                addRankCase(condition, *chainEntry, unmatchedConditions);
+            unmatchedConditions.push_back(condition);
+            visitedIfStmts.insert(ifStmt);
+
+            const IfStmt *elseIf = dyn_cast_or_null<IfStmt>(ifStmt->getElse());
+            if (!elseIf) break;
+            chainEntry = &ifStmts_[ifStmtIndices_.lookup(elseIf)];
+        }
+
+        // rank case for else
+        if (chainEntry->ifStmt_->getElse()) {
+            rankCaseForBranch_[chainEntry->elseBranch_] =
+                addRankCase(nullptr, *chainEntry, unmatchedConditions);
+        }
+    }
+
+    // attribute calls to all rank cases enclosing them
+    for (const CallEvent &event : callEvents_) {
+        if (!isInRankCase(event.branch_)) continue;
+        const llvm::ArrayRef<const MPICall *> mpiCalls =
+            event.mpiCall_ ? llvm::ArrayRef<const MPICall *>(event.mpiCall_)
+                           : functionSummary(event.callee_);
+
+        for (size_t branch = event.branch_; branch != kNone;
+             branch = branches_[branch].parent_) {
+            if (rankCaseForBranch_[branch] != kNone) {
+                for (const MPICall *mpiCall : mpiCalls) {
+                    analysisContext_.rankCases()[rankCaseForBranch_[branch]]
+                        ->addCall(mpiCall);
+                }
+            }
+        }
+    }
+
+    for (const MPIRankCase *rankCase : analysisContext_.rankCases()) {
+        if (rankCase->functionDecl()) {
+            checkerAST_.setCurrentlyVisitedFunction(rankCase->functionDecl());
+        }
+        checkerAST_.checkForCollectiveCalls(*rankCase);
+    }
+}
+
+/**
+ * Appends a rank case.
  *
- * @param ifStmt
+ * @param matchedCondition condition to enter the case, nullptr for else
+ * @param entry if statement the case belongs to
+ * @param unmatchedConditions
  *
- * @return if rank var is used
+ * @return index of the rank case
  */
-bool TranslationUnitVisitor::isRankBranch(clang::IfStmt *ifStmt) {
-    bool isInRankBranch{false};
-    ConditionVisitor ConditionVisitor{ifStmt->getCond()};
-    for (const VarDecl *const varDecl : ConditionVisitor.vars()) {
-        if (cont::isContained(MPIRank::visitedRankVariables, varDecl)) {
-            isInRankBranch = true;
-            break;
+size_t TranslationUnitVisitor::addRankCase(
+    const ConditionVisitor *const matchedCondition, const IfStmtEntry &entry,
+    const std::vector<const ConditionVisitor *> &unmatchedConditions) {
+    analysisContext_.rankCases().push_back(arena_.createRankCase(
+        matchedCondition,
+        arena_.copyArray<const ConditionVisitor *>(unmatchedConditions),
+        entry.functionDecl_));
+    return analysisContext_.rankCases().size() - 1;
+}
+
+/**
+ * Returns the mpi calls a function executes outside of its own rank
+ * cases, including those of its callees, in order of appearance.
+ * Summaries are memoized, so that callee bodies are summarized once
+ * however many callers they have. Recursive calls contribute no calls.
+ *
+ * @param definition function definition
+ *
+ * @return mpi calls of the function
+ */
+llvm::ArrayRef<const MPICall *> TranslationUnitVisitor::functionSummary(
+    const FunctionDecl *definition) {
+    auto summary = functionSummaries_.find(definition);
+    if (summary != functionSummaries_.end()) return summary->second;
+
+    auto events = functionEvents_.find(definition);
+    if (events == functionEvents_.end()) return {};
+
+    // breaks cycles of recursive calls
+    functionSummaries_[definition] = {};
+
+    llvm::SmallVector<const MPICall *, 8> mpiCalls;
+    for (size_t i = events->second.first; i < events->second.second; ++i) {
+        const CallEvent &event = callEvents_[i];
+        // calls in rank cases of the callee are matched as part of those
+        if (isInRankCase(event.branch_)) continue;
+
+        if (event.mpiCall_) {
+            mpiCalls.push_back(event.mpiCall_);
+        } else {
+            const llvm::ArrayRef<const MPICall *> calleeCalls =
+                functionSummary(event.callee_);
+            mpiCalls.append(calleeCalls.begin(), calleeCalls.end());
         }
     }
-    return isInRankBranch;
+
+    const llvm::ArrayRef<const MPICall *> calls =
+        arena_.copyArray<const MPICall *>(mpiCalls);
+    functionSummaries_[definition] = calls;
+    return calls;
+}
+
+/**
+ * Checks if a branch is enclosed by a rank case.
+ *
+ * @param branch innermost branch, kNone on function level
+ *
+ * @return if a rank case encloses the branch
+ */
+bool TranslationUnitVisitor::isInRankCase(size_t branch) const {
+    for (; branch != kNone; branch = branches_[branch].parent_) {
+        if (rankCaseForBranch_[branch] != kNone) return true;
+    }
+    return false;
 }
 
+/**
+ * Checks if a rank variable is used in branch condition.
+ *
+ * @param entry
+ *
+ * @return if rank var is used
+ */
+bool TranslationUnitVisitor::isRankBranch(const IfStmtEntry &entry) const {
+    for (const VarDecl *const varDecl : entry.conditionVars_) {
+        if (analysisContext_.rankVariables().count(varDecl)) return true;
+    }
+    return false;
+}
 
 }  // end of namespace: mpi
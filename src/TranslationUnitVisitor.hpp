@@ -44,26 +44,95 @@ namespace mpi {
  * Main visitor class to collect information about MPI calls traversing
  * the AST of a translation unit, checking invariants during the traversal
  * through MPICheckerAST.
+ *
+ * The translation unit is traversed once. Every mpi call is recorded
+ * together with the innermost branch enclosing it. Rank variables are
+ * resolved after the traversal, when rank cases are built from this
+ * flat index without walking any subtree again.
+ *
+ * Calls to functions defined in the translation unit are recorded as
+ * well. Their mpi calls are spliced into enclosing rank cases using a
+ * per function summary, computed once bottom-up over the call graph.
  */
 class TranslationUnitVisitor
     : public clang::RecursiveASTVisitor<TranslationUnitVisitor> {
 public:
     TranslationUnitVisitor(clang::ento::BugReporter &bugReporter,
                            const clang::ento::CheckerBase &checkerBase,
-                           clang::ento::AnalysisManager &analysisManager)
-        : checkerAST_{bugReporter, checkerBase, analysisManager} {}
+                           clang::ento::AnalysisManager &analysisManager,
+                           MPISharedContext &sharedContext,
+                           MPIAnalysisContext &analysisContext)
+        : checkerAST_{bugReporter, checkerBase, analysisManager,
+                      sharedContext, analysisContext},
+          sharedContext_{sharedContext},
+          canonicalForms_{sharedContext.canonicalForms()},
+          analysisContext_{analysisContext},
+          arena_{analysisContext.arena()} {}
 
     // visitor callbacks
     bool VisitFunctionDecl(clang::FunctionDecl *);
+    bool TraverseDecl(clang::Decl *);
     bool VisitCallExpr(clang::CallExpr *);
-    bool VisitIfStmt(clang::IfStmt *);
+    bool VisitDeclRefExpr(clang::DeclRefExpr *);
+    bool TraverseIfStmt(clang::IfStmt *);
+
+    void collectRankCases();
 
     MPICheckerAST checkerAST_;
 
 private:
-    bool isRankBranch(clang::IfStmt *ifStmt);
+    // if statement with the variables used in its condition
+    struct IfStmtEntry {
+        clang::IfStmt *ifStmt_;
+        const clang::FunctionDecl *functionDecl_;
+        size_t thenBranch_;
+        size_t elseBranch_;
+        llvm::SmallVector<const clang::VarDecl *, 2> conditionVars_;
+    };
+
+    // then or else branch of an if statement
+    struct Branch {
+        size_t parent_;  // enclosing branch, kNone on function level
+    };
+
+    // mpi call or call of a defined function,
+    // with the innermost branch it is contained in
+    struct CallEvent {
+        const MPICall *mpiCall_;  // nullptr for function calls
+        const clang::FunctionDecl *callee_;  // definition of the callee
+        size_t branch_;
+    };
+
+    static const size_t kNone = static_cast<size_t>(-1);
+
+    bool isRankBranch(const IfStmtEntry &) const;
+    bool isInRankCase(size_t) const;
+    llvm::ArrayRef<const MPICall *> functionSummary(
+        const clang::FunctionDecl *);
+    size_t addRankCase(const ConditionVisitor *const, const IfStmtEntry &,
+                       const std::vector<const ConditionVisitor *> &);
+
+    // in traversal order
+    std::vector<IfStmtEntry> ifStmts_;
+    std::vector<Branch> branches_;
+    std::vector<CallEvent> callEvents_;
+    llvm::DenseMap<const clang::IfStmt *, size_t> ifStmtIndices_;
+    // range of call events of each function definition
+    llvm::DenseMap<const clang::FunctionDecl *, std::pair<size_t, size_t>>
+        functionEvents_;
+    // mpi calls of each function outside its own rank cases, in order
+    llvm::DenseMap<const clang::FunctionDecl *,
+                   llvm::ArrayRef<const MPICall *>> functionSummaries_;
+    // rank case index for each branch, kNone if not a rank case
+    std::vector<size_t> rankCaseForBranch_;
+    MPISharedContext &sharedContext_;
+    CanonicalFormTable &canonicalForms_;
+    MPIAnalysisContext &analysisContext_;
+    MPIArena &arena_;
 
-    llvm::SmallVector<clang::IfStmt *, 8> visitedIfStmts_;
+    const clang::FunctionDecl *currentFunctionDecl_{nullptr};
+    size_t currentBranch_{kNone};
+    size_t currentCondition_{kNone};
 };
 
 }  // end of namespace: mpi
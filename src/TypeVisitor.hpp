@@ -26,6 +26,9 @@
 #define TYPEVISITOR_HPP_KOZYUVZH
 
 #include "clang/AST/RecursiveASTVisitor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "MPIDatatype.hpp"
 
 namespace mpi {
 
@@ -72,5 +75,54 @@ private:
     clang::ComplexType *complexType_{nullptr};
 };
 
+// classification of a type, as needed to match it against mpi datatypes
+struct TypeClass {
+    const clang::BuiltinType *builtinType_;
+    bool isComplex_;
+    bool isTypedef_;
+    // datatype of exact width typedefs (e.g. int16_t), kUnknown for others
+    MPIDatatype exactWidthDatatype_;
+};
+
+/**
+ * Per translation unit cache of type classifications. Types are uniqued
+ * by the ast context, so each distinct type is traversed once. Keys keep
+ * their typedef sugar, as typedefs are classified differently from their
+ * canonical type.
+ */
+class TypeClassCache {
+public:
+    TypeClass classify(const clang::QualType qualType) {
+        auto typeClass = typeClasses_.find(qualType);
+        if (typeClass != typeClasses_.end()) return typeClass->second;
+
+        const TypeVisitor typeVisitor{qualType};
+        const TypeClass result{
+            typeVisitor.builtinType(), typeVisitor.complexType() != nullptr,
+            typeVisitor.isTypedefType(),
+            typeVisitor.isTypedefType()
+                ? exactWidthDatatype(typeVisitor.typedefTypeName())
+                : MPIDatatype::kUnknown};
+        typeClasses_[qualType] = result;
+        return result;
+    }
+
+private:
+    static MPIDatatype exactWidthDatatype(const llvm::StringRef typedefName) {
+        return llvm::StringSwitch<MPIDatatype>(typedefName)
+            .Case("int8_t", MPIDatatype::kInt8)
+            .Case("int16_t", MPIDatatype::kInt16)
+            .Case("int32_t", MPIDatatype::kInt32)
+            .Case("int64_t", MPIDatatype::kInt64)
+            .Case("uint8_t", MPIDatatype::kUInt8)
+            .Case("uint16_t", MPIDatatype::kUInt16)
+            .Case("uint32_t", MPIDatatype::kUInt32)
+            .Case("uint64_t", MPIDatatype::kUInt64)
+            .Default(MPIDatatype::kUnknown);
+    }
+
+    llvm::DenseMap<clang::QualType, TypeClass> typeClasses_;
+};
+
 }  // end of namespace: mpi
 #endif  // end of include guard: TYPEVISITOR_HPP_KOZYUVZH
@@ -176,3 +176,180 @@ void unreachableCall() {
         MPI_Recv(&buf, 1, MPI_INT, rank - 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); // expected-warning{{Call is not reachable. Schema leads to a deadlock.}}
     }
 }
+
+// each phase only becomes reachable after the previous one was matched,
+// a fixed number of matching rounds stops before the last phase
+void sixPhases() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Recv(&buf, 1, MPI_INT, rank + 1, 100, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Send(&buf, 1, MPI_INT, rank + 2, 101, MPI_COMM_WORLD);
+        MPI_Send(&buf, 1, MPI_INT, rank + 1, 102, MPI_COMM_WORLD);
+        MPI_Recv(&buf, 1, MPI_INT, rank + 2, 104, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Send(&buf, 1, MPI_INT, rank + 1, 105, MPI_COMM_WORLD);
+    }
+    else if (rank == 1) {
+        MPI_Send(&buf, 1, MPI_INT, rank - 1, 100, MPI_COMM_WORLD);
+        MPI_Recv(&buf, 1, MPI_INT, rank - 1, 102, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Recv(&buf, 1, MPI_INT, rank + 1, 103, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Recv(&buf, 1, MPI_INT, rank - 1, 105, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    else if (rank == 2) {
+        MPI_Recv(&buf, 1, MPI_INT, rank - 2, 101, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Send(&buf, 1, MPI_INT, rank - 1, 103, MPI_COMM_WORLD);
+        MPI_Send(&buf, 1, MPI_INT, rank - 2, 104, MPI_COMM_WORLD);
+    }
+}
+
+// initializers of constant datatypes are only followed a bounded depth
+void selfReferencingDatatype() {
+    int rank = 0;
+    int buf = 0;
+    const MPI_Datatype datatype = datatype;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Send(&buf, 1, datatype, rank + 1, 200, MPI_COMM_WORLD);
+    }
+    else if (rank == 1) {
+        MPI_Recv(&buf, 1, datatype, rank - 1, 200, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+}
+
+void sendToNext(int rank, double *buf) {
+    MPI_Send(buf, 1, MPI_DOUBLE, rank + 1, 0, MPI_COMM_WORLD);
+}
+void receiveFromPrevious(int rank, double *buf) {
+    MPI_Recv(buf, 1, MPI_DOUBLE, rank - 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+void matchedInCallees() {
+    int rank = 0;
+    double buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        sendToNext(rank, &buf);
+    }
+    else if (rank == 1) {
+        receiveFromPrevious(rank, &buf);
+    }
+}
+
+void sendToPrevious(int rank, double *buf) {
+    MPI_Send(buf, 1, MPI_DOUBLE, rank - 1, 0, MPI_COMM_WORLD); // expected-warning{{No matching receive function found.}}
+}
+void missingReceiveInCallee() {
+    int rank = 0;
+    double buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 1) {
+        sendToPrevious(rank, &buf);
+    }
+}
+
+#define HALO_TYPE MPI_DOUBLE
+void datatypeMacroAlias() {
+    int rank = 0;
+    double buf = 0;
+    const MPI_Datatype datatype = MPI_DOUBLE;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Send(&buf, 1, HALO_TYPE, rank + 1, 0, MPI_COMM_WORLD);
+    }
+    else if (rank == 1) {
+        MPI_Recv(&buf, 1, datatype, rank - 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+}
+
+void datatypeMacroMismatch() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Send(&buf, 1, HALO_TYPE, rank + 1, 0, MPI_COMM_WORLD); // expected-warning{{Buffer type and specified MPI type do not match. }}
+    }
+    else if (rank == 1) {
+        MPI_Recv(&buf, 1, HALO_TYPE, rank - 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); // expected-warning{{Buffer type and specified MPI type do not match. }}
+    }
+}
+
+void requestArrayInLoop() {
+    double buf = 0;
+    MPI_Request requests[2];
+    for (int i = 0; i < 2; ++i) {
+        MPI_Irecv(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &requests[i]);
+    }
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+}
+
+void missingWaitInLoop() {
+    double buf = 0;
+    MPI_Request requests[2];
+    for (int i = 0; i < 2; ++i) {
+        MPI_Irecv(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &requests[i]); // expected-warning{{Nonblocking call using request requests[1] has no matching wait. }}
+    }
+    MPI_Wait(&requests[0], MPI_STATUS_IGNORE);
+}
+
+void missingWaitAtUnknownIndex(int index) {
+    double buf = 0;
+    MPI_Request requests[2];
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &requests[index]); // expected-warning{{Nonblocking call using request requests has no matching wait. }}
+}
+
+void completedByTest() {
+    int flag = 0;
+    double buf = 0;
+    MPI_Request request;
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &request);
+    while (!flag) {
+        MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+    }
+}
+
+void completedByWaitany() {
+    int index = 0;
+    double buf = 0;
+    MPI_Request requests[2];
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &requests[0]);
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &requests[1]);
+    for (int i = 0; i < 2; ++i) {
+        MPI_Waitany(2, requests, &index, MPI_STATUS_IGNORE);
+    }
+}
+
+void missingWaitAfterRepost() {
+    double buf = 0;
+    MPI_Request request;
+    MPI_Isend(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &request);
+    MPI_Isend(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &request); // expected-warning{{Request request is already in use by nonblocking call MPI_Isend in line 324. }}
+    MPI_Isend(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &request); // expected-warning{{Request request is already in use by nonblocking call MPI_Isend in line 325. }} expected-warning{{Nonblocking call using request request has no matching wait. }}
+}
+
+void repostedBatchAtUnknownIndices(int offset) {
+    double buf = 0;
+    MPI_Request requests[2];
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 2; ++i) {
+            MPI_Irecv(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &requests[(offset + i) % 2]);
+        }
+        MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+    }
+}
+
+void missingWaitAfterWaitany() {
+    int index = 0;
+    double buf = 0;
+    MPI_Request requests[2];
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &requests[0]);
+    MPI_Irecv(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &requests[1]); // expected-warning{{Nonblocking call using request requests has no matching wait. }}
+    MPI_Waitany(2, requests, &index, MPI_STATUS_IGNORE);
+}
+
+void missingWaitOnCopiedHandle() {
+    double buf = 0;
+    MPI_Request request;
+    MPI_Isend(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &request); // expected-warning{{Nonblocking call using request request has no matching wait. }}
+    MPI_Request requests[1] = {request};
+    MPI_Barrier(MPI_COMM_WORLD);
+}
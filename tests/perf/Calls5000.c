@@ -1,3 +1,13 @@
+// RUN: %mpi_workload --rank-cases 50 --calls-per-case 10 --functions 10 -o %t.c
+// RUN: echo '// expected-no-diagnostics' >> %t.c
+// RUN: %mpi_budget --budget %s -- %clang_cc1 -I/usr/local/include/ -analyze -analyzer-checker=lx.MPIChecker -verify %t.c
+// BUDGET: unrecorded
+// REQUIRES: mpi-perf-record
+
+// A translation unit of 5,000 point to point calls in 10 functions of 50
+// rank cases each. Rank cases of all functions are matched against each
+// other, the path sensitive checks explore every rank case branch.
+
 /*
  The MIT License (MIT)
 
@@ -21,35 +31,3 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
 */
-
-#ifndef UTILITY_HPP_SVQZWTL8
-#define UTILITY_HPP_SVQZWTL8
-
-#include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
-
-namespace util {
-
-/**
- * Returns part of the code specified by range unmodified as string ref.
- *
- * @param source range
- * @param analysis manager
- *
- * @return code part as string ref
- */
-clang::StringRef sourceRangeAsStringRef(const clang::SourceRange &,
-                                        clang::ento::AnalysisManager &);
-
-/**
- * Split string by delimiter.
- *
- * @param string to split
- * @param delimiter
- *
- * @return string array split by delimiter
- */
-std::vector<std::string> split(const std::string &, char);
-
-}  // end of namespace: util
-
-#endif  // end of include guard: UTILITY_HPP_SVQZWTL8
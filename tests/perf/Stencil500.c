@@ -0,0 +1,33 @@
+// RUN: %mpi_workload --rank-cases 500 --calls-per-case 2 --depth 1 -o %t.c
+// RUN: echo '// expected-no-diagnostics' >> %t.c
+// RUN: %mpi_budget --budget %s -- %clang_cc1 -I/usr/local/include/ -analyze -analyzer-checker=lx.MPIChecker -verify %t.c
+// BUDGET: unrecorded
+// REQUIRES: mpi-perf-record
+
+// A stencil exchange of 500 rank cases, neighbouring cases send to and
+// receive from each other. Dominated by the point to point schema
+// validation, which compares the calls of all rank cases.
+
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+
+"""
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+"""
+
+# Runs a command and compares its cpu time (user + system) and peak
+# resident set size against the budget recorded in a test file. The budget
+# is a line of the form
+#
+#   // BUDGET: cpu-seconds=<float> peak-rss-kib=<int>
+#
+# or "// BUDGET: unrecorded" for a test that was not measured yet. Such a
+# test also carries "// REQUIRES: mpi-perf-record", so that lit only runs it
+# to record the budget. Recording removes that line.
+#
+# Exits non zero if the command fails, the budget is unrecorded or a
+# measurement exceeds its budget by more than the margin. With --record the
+# measurements are written to the budget line instead.
+#
+# usage: checkBudget.py --budget TEST [--margin FRACTION] [--record]
+#                       -- COMMAND...
+
+from __future__ import print_function
+
+import argparse
+import math
+import os
+import re
+import subprocess
+import sys
+
+BUDGET = re.compile(r'^// BUDGET: (?:cpu-seconds=([0-9.]+) '
+                    r'peak-rss-kib=([0-9]+)|unrecorded)$', re.MULTILINE)
+UNRECORDED = '// REQUIRES: mpi-perf-record\n'
+
+
+def run(command):
+    """Runs a command, returns exit status, cpu seconds and peak rss in KiB."""
+    with open(os.devnull, 'w') as devnull:
+        process = subprocess.Popen(command, stdout=devnull)
+        _, status, usage = os.wait4(process.pid, 0)
+    # ru_maxrss is given in bytes on darwin and in KiB elsewhere
+    peak = usage.ru_maxrss // 1024 if sys.platform == 'darwin' \
+        else usage.ru_maxrss
+    return status, usage.ru_utime + usage.ru_stime, peak
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Check the analysis cost of a test against its budget.')
+    parser.add_argument('--budget', required=True,
+                        help='test file containing the budget line')
+    parser.add_argument('--margin', type=float, default=0.25,
+                        help='allowed excess over a budget (default: 0.25)')
+    parser.add_argument('--record', action='store_true',
+                        help='write the measurements to the budget line')
+    parser.add_argument('command', nargs=argparse.REMAINDER,
+                        help='command to measure, preceded by --')
+    args = parser.parse_args()
+    command = args.command[1:] if args.command[:1] == ['--'] \
+        else args.command
+    if not command:
+        parser.error('no command given')
+
+    # tests are symlinked into clang's test tree, record in the original
+    path = os.path.realpath(args.budget)
+    with open(path) as test:
+        source = test.read()
+    budget = BUDGET.search(source)
+    if not budget:
+        sys.exit('checkBudget.py: no budget line in ' + path)
+
+    status, cpu, peak = run(command)
+    if status:
+        sys.exit('checkBudget.py: command failed: ' + ' '.join(command))
+    isRecorded = budget.group(1) is not None
+    if isRecorded:
+        print('cpu time: %.2fs, budget %ss' % (cpu, budget.group(1)))
+        print('peak rss: %d KiB, budget %s KiB' % (peak, budget.group(2)))
+    else:
+        print('cpu time: %.2fs, peak rss: %d KiB, no budget recorded' %
+              (cpu, peak))
+
+    if args.record:
+        # round up, a budget rounded down to 0.00s could never be met
+        cpuBudget = max(math.ceil(cpu * 100), 1) / 100.0
+        line = '// BUDGET: cpu-seconds=%.2f peak-rss-kib=%d' % (cpuBudget,
+                                                             peak)
+        with open(path, 'w') as test:
+            test.write(source[:budget.start()] + line +
+                       source[budget.end():].replace(UNRECORDED, '', 1))
+        return
+    if not isRecorded:
+        sys.exit('checkBudget.py: no budget recorded in ' + path +
+                 ', run with --record on the reference machine')
+
+    limit = 1.0 + args.margin
+    exceeded = []
+    if cpu > float(budget.group(1)) * limit:
+        exceeded.append('cpu time')
+    if peak > int(budget.group(2)) * limit:
+        exceeded.append('peak rss')
+    if exceeded:
+        sys.exit('checkBudget.py: %s over budget by more than %d%%' %
+                 (' and '.join(exceeded), args.margin * 100))
+
+
+if __name__ == '__main__':
+    main()
@@ -1,3 +1,5 @@
+// Worker of MasterWorker.c, see there.
+
 /*
  The MIT License (MIT)
 
@@ -22,33 +24,29 @@
  SOFTWARE.
 */
 
-#ifndef CALLEXPRVISITOR_HPP_7XGM9NP3
-#define CALLEXPRVISITOR_HPP_7XGM9NP3
-
-namespace mpi {
+// expected-no-diagnostics
 
-/**
- * Visitor class to collect call expressions from a statement.
- */
-class CallExprVisitor : public clang::RecursiveASTVisitor<CallExprVisitor> {
-public:
-    CallExprVisitor(const clang::Stmt *const stmt) {
-        TraverseStmt(const_cast<clang::Stmt *>(stmt));
-    }
+#include <mpi.h>
 
-    bool VisitCallExpr(clang::CallExpr *callExpr) {
-        callExprs_.push_back(callExpr);
-        return true;
+void worker() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 1) {
+        MPI_Recv(&buf, 1, MPI_INT, rank - 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
     }
-
-    const llvm::SmallVectorImpl<clang::CallExpr *> &callExprs() const {
-        return callExprs_;
+}
+
+void workerDeadlock() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 1) {
+        MPI_Recv(&buf, 1, MPI_INT, rank - 1, 3, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        // CHECK-DAG: Inputs/Worker.c:[[@LINE+1]]:9: warning: Call is not reachable. Schema leads to a deadlock.
+        MPI_Send(&buf, 1, MPI_INT, rank - 1, 2, MPI_COMM_WORLD);
     }
+}
 
-private:
-    llvm::SmallVector<clang::CallExpr *, 8> callExprs_;
-};
-
-}  // end of namespace: mpi
-
-#endif  // end of include guard: CALLEXPRVISITOR_HPP_7XGM9NP3
+// CHECK-NOT: Inputs/Worker.c
+// CHECK: 2 summaries merged
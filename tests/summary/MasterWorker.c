@@ -0,0 +1,62 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %clang_cc1 -I/usr/local/include/ -analyze -analyzer-checker=lx.MPIASTChecker -analyzer-config mpi-summary-dir=%t -verify %s
+// RUN: %clang_cc1 -I/usr/local/include/ -analyze -analyzer-checker=lx.MPIASTChecker -analyzer-config mpi-summary-dir=%t -verify %S/Inputs/Worker.c
+// RUN: mpi-check --summary-dir=%t --merge-only 2>&1 | FileCheck %s
+// RUN: mpi-check --summary-dir=%t --merge-only 2>&1 | FileCheck %S/Inputs/Worker.c
+
+// The master and its worker are analysed as separate translation units.
+// Both only write summaries, point to point calls are matched when the
+// summaries are merged.
+
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+// expected-no-diagnostics
+
+#include <mpi.h>
+
+void master() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Send(&buf, 1, MPI_INT, rank + 1, 0, MPI_COMM_WORLD);
+        // CHECK-DAG: MasterWorker.c:[[@LINE+1]]:9: warning: No matching receive function found.
+        MPI_Send(&buf, 1, MPI_INT, rank + 1, 1, MPI_COMM_WORLD);
+    }
+}
+
+void masterDeadlock() {
+    int rank = 0;
+    int buf = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        MPI_Recv(&buf, 1, MPI_INT, rank + 1, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        // CHECK-DAG: MasterWorker.c:[[@LINE+1]]:9: warning: Call is not reachable. Schema leads to a deadlock.
+        MPI_Send(&buf, 1, MPI_INT, rank + 1, 3, MPI_COMM_WORLD);
+    }
+}
+
+// CHECK-NOT: MasterWorker.c
+// CHECK: 2 summaries merged
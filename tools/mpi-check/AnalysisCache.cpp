@@ -0,0 +1,137 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+#include "AnalysisCache.hpp"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mpi {
+
+namespace {
+// first line of every entry, bump if the entry layout changes
+const char kEntryHeader[] = "mpi-check-cache 1\n";
+}  // end of anonymous namespace
+
+/**
+ * Creates the cache directory if it does not exist yet.
+ *
+ * @return success
+ */
+bool AnalysisCache::create() const {
+    if (std::error_code errorCode =
+            llvm::sys::fs::create_directories(directory_)) {
+        llvm::errs() << "mpi-check: " << directory_ << ": "
+                     << errorCode.message() << "\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the entry stored for a key.
+ *
+ * @param key
+ * @param entry loaded entry
+ *
+ * @return true on a hit, false if there is no valid entry
+ */
+bool AnalysisCache::lookup(llvm::StringRef key, CacheEntry &entry) const {
+    auto buffer = llvm::MemoryBuffer::getFile(entryPath(key));
+    if (!buffer) return false;
+
+    llvm::StringRef content{(*buffer)->getBuffer()};
+    if (!content.startswith(kEntryHeader)) return false;
+    content = content.drop_front(sizeof(kEntryHeader) - 1);
+
+    // sizes line: warnings, output, summary name, summary
+    const auto sizesLine = content.split('\n');
+    llvm::StringRef sizes{sizesLine.first};
+    content = sizesLine.second;
+    unsigned long long values[4];
+    for (unsigned long long &value : values) {
+        const auto field = sizes.ltrim().split(' ');
+        if (field.first.getAsInteger(10, value)) return false;
+        sizes = field.second;
+    }
+    if (content.size() != values[1] + values[2] + values[3]) return false;
+
+    entry.warningCount_ = values[0];
+    entry.output_ = content.substr(0, values[1]).str();
+    entry.summaryName_ = content.substr(values[1], values[2]).str();
+    entry.summary_ = content.substr(values[1] + values[2], values[3]).str();
+    return true;
+}
+
+/**
+ * Stores the entry for a key. The entry is written to a unique temporary
+ * file first and renamed, so that concurrent runs sharing the cache never
+ * read partial entries.
+ *
+ * @param key
+ * @param entry
+ *
+ * @return success
+ */
+bool AnalysisCache::store(llvm::StringRef key, const CacheEntry &entry) const {
+    const std::string path{entryPath(key)};
+    int fd;
+    llvm::SmallString<128> tempPath;
+    if (llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%", fd, tempPath)) {
+        return false;
+    }
+    {
+        llvm::raw_fd_ostream stream{fd, true};
+        stream << kEntryHeader << entry.warningCount_ << ' '
+               << entry.output_.size() << ' ' << entry.summaryName_.size()
+               << ' ' << entry.summary_.size() << '\n'
+               << entry.output_ << entry.summaryName_ << entry.summary_;
+        stream.close();
+        if (stream.has_error()) {
+            stream.clear_error();
+            llvm::sys::fs::remove(tempPath);
+            return false;
+        }
+    }
+    if (llvm::sys::fs::rename(tempPath, path)) {
+        llvm::sys::fs::remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @param key
+ *
+ * @return path of the entry file for a key
+ */
+std::string AnalysisCache::entryPath(llvm::StringRef key) const {
+    llvm::SmallString<128> path{directory_};
+    llvm::sys::path::append(path, key + ".mpicache");
+    return path.str().str();
+}
+
+}  // end of namespace: mpi
@@ -22,38 +22,40 @@
  SOFTWARE.
 */
 
-#ifndef RANKVISITOR_HPP_WZL2H4SR
-#define RANKVISITOR_HPP_WZL2H4SR
+#ifndef ANALYSISCACHE_HPP_R4WQ8ZTD
+#define ANALYSISCACHE_HPP_R4WQ8ZTD
 
-#include "MPIFunctionClassifier.hpp"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+// on-disk cache of analysis results, keyed by a content hash of the
+// preprocessed translation unit, the tool binary and the analysis options
 
 namespace mpi {
 
-/**
- * Visitor class to collect rank variables.
- */
-class RankVisitor : public clang::RecursiveASTVisitor<RankVisitor> {
+// stored result of analysing one translation unit
+struct CacheEntry {
+    std::string output_;  // printed diagnostics
+    unsigned warningCount_{0};
+    // summary written in summary mode, restored on a hit
+    std::string summaryName_;
+    std::string summary_;
+};
+
+class AnalysisCache {
 public:
-    RankVisitor(clang::ento::AnalysisManager &analysisManager)
-        : funcClassifier_{analysisManager} {}
-
-    // collect rank vars
-    bool VisitCallExpr(clang::CallExpr *callExpr) {
-        if (funcClassifier_.isMPIType(
-                callExpr->getDirectCallee()->getIdentifier())) {
-            MPICall mpiCall{callExpr};
-            if (funcClassifier_.isMPI_Comm_rank(mpiCall)) {
-                clang::VarDecl *varDecl = mpiCall.arguments()[1].vars()[0];
-                MPIRank::visitedRankVariables.insert(varDecl);
-            }
-        }
-
-        return true;
-    }
+    AnalysisCache(llvm::StringRef directory) : directory_{directory} {}
+
+    bool create() const;
+    bool lookup(llvm::StringRef key, CacheEntry &entry) const;
+    bool store(llvm::StringRef key, const CacheEntry &entry) const;
 
 private:
-    MPIFunctionClassifier funcClassifier_;
+    std::string entryPath(llvm::StringRef key) const;
+
+    const std::string directory_;
 };
 
 }  // end of namespace: mpi
-#endif  // end of include guard: RANKVISITOR_HPP_WZL2H4SR
+
+#endif  // end of include guard: ANALYSISCACHE_HPP_R4WQ8ZTD
@@ -0,0 +1,568 @@
+/*
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Alexander Droste
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+*/
+
+// Standalone driver running the ast based MPI checks for all translation
+// units of a compilation database on a pool of threads. Translation units
+// are only parsed and analysed, no build artifacts are produced.
+
+#include "clang/Basic/FileManager.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/StaticAnalyzer/Core/AnalyzerOptions.h"
+#include "clang/StaticAnalyzer/Frontend/FrontendActions.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "AnalysisCache.hpp"
+#include "MPISummary.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+using namespace clang;
+using namespace clang::tooling;
+
+namespace {
+
+llvm::cl::OptionCategory mpiCheckCategory{"mpi-check options"};
+
+llvm::cl::opt<std::string> buildPath{
+    "p", llvm::cl::desc("Build path containing compile_commands.json"),
+    llvm::cl::init("."), llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::opt<unsigned> jobCount{
+    "j",
+    llvm::cl::desc("Number of translation units analysed in parallel "
+                   "(default: number of hardware threads)"),
+    llvm::cl::init(0), llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::opt<std::string> summaryDir{
+    "summary-dir",
+    llvm::cl::desc("Write per translation unit summaries to this directory "
+                   "and match point to point calls across all of them"),
+    llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::opt<bool> isMergeOnly{
+    "merge-only",
+    llvm::cl::desc("Only merge the summaries already in --summary-dir"),
+    llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::opt<std::string> cacheDir{
+    "cache-dir",
+    llvm::cl::desc("Cache results in this directory and replay them for "
+                   "translation units whose preprocessed content, compile "
+                   "command and mpi-check binary did not change"),
+    llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::opt<std::string> statsDir{
+    "stats-dir",
+    llvm::cl::desc("Write timers and counters of the checks per translation "
+                   "unit as json to this directory"),
+    llvm::cl::cat(mpiCheckCategory)};
+
+llvm::cl::list<std::string> sourcePaths{
+    llvm::cl::Positional,
+    llvm::cl::desc("[<source> ...] (default: all files of the database)"),
+    llvm::cl::ZeroOrMore, llvm::cl::cat(mpiCheckCategory)};
+
+// checker running the ast checks only, skipping path exploration
+const char kChecker[] = "lx.MPIASTChecker";
+
+/**
+ * Runs the static analyzer with only the ast based MPI checks enabled,
+ * whatever analyzer options the compile command specifies.
+ */
+class MPICheckActionFactory : public FrontendActionFactory {
+public:
+    FrontendAction *create() override { return new ento::AnalysisAction; }
+
+    bool runInvocation(CompilerInvocation *invocation, FileManager *files,
+                       DiagnosticConsumer *diagConsumer) override {
+        AnalyzerOptions &analyzerOpts = *invocation->getAnalyzerOpts();
+        analyzerOpts.CheckersControlList = {{kChecker, true}};
+        analyzerOpts.AnalysisDiagOpt = PD_TEXT;
+        if (!summaryDir.empty()) {
+            analyzerOpts.Config["mpi-summary-dir"] = summaryDir;
+        }
+        if (!statsDir.empty()) {
+            analyzerOpts.Config["mpi-stats-dir"] = statsDir;
+        }
+        return FrontendActionFactory::runInvocation(invocation, files,
+                                                    diagConsumer);
+    }
+};
+
+/**
+ * Hashes the preprocessed token stream of a translation unit. Every token
+ * is hashed with its spelling and presumed location, as diagnostics report
+ * locations. Comments and whitespace within lines do not change the hash.
+ */
+class PreprocessedHashAction : public PreprocessorFrontendAction {
+public:
+    PreprocessedHashAction(llvm::MD5 &hash, std::string &mainFilePath)
+        : hash_(hash), mainFilePath_(mainFilePath) {}
+
+protected:
+    void ExecuteAction() override {
+        Preprocessor &preprocessor = getCompilerInstance().getPreprocessor();
+        SourceManager &sourceManager = getCompilerInstance().getSourceManager();
+        if (const FileEntry *mainFile = sourceManager.getFileEntryForID(
+                sourceManager.getMainFileID())) {
+            mainFilePath_ = mainFile->getName();
+        }
+
+        std::string lastFilename;
+        Token token;
+        preprocessor.EnterMainSourceFile();
+        do {
+            preprocessor.Lex(token);
+            const PresumedLoc loc = sourceManager.getPresumedLoc(
+                sourceManager.getExpansionLoc(token.getLocation()));
+            if (loc.isValid()) {
+                if (lastFilename != loc.getFilename()) {
+                    lastFilename = loc.getFilename();
+                    hash_.update(lastFilename);
+                }
+                const unsigned position[] = {loc.getLine(), loc.getColumn()};
+                hash_.update(llvm::StringRef{
+                    reinterpret_cast<const char *>(position),
+                    sizeof(position)});
+            }
+            hash_.update(preprocessor.getSpelling(token));
+            hash_.update(llvm::StringRef{"\0", 1});
+        } while (token.isNot(tok::eof));
+    }
+
+private:
+    llvm::MD5 &hash_;
+    std::string &mainFilePath_;
+};
+
+class PreprocessedHashFactory : public FrontendActionFactory {
+public:
+    PreprocessedHashFactory(llvm::MD5 &hash, std::string &mainFilePath)
+        : hash_(hash), mainFilePath_(mainFilePath) {}
+
+    FrontendAction *create() override {
+        return new PreprocessedHashAction{hash_, mainFilePath_};
+    }
+
+private:
+    llvm::MD5 &hash_;
+    std::string &mainFilePath_;
+};
+
+// hash of the mpi-check binary, which contains the checker
+std::string toolHash;
+
+/**
+ * Hashes the running executable, so that cache entries are invalidated
+ * whenever mpi-check or the linked checker is rebuilt.
+ *
+ * @param argv0
+ *
+ * @return md5 of the executable, empty if it can not be read
+ */
+std::string executableHash(const char *argv0) {
+    auto buffer = llvm::MemoryBuffer::getFile(llvm::sys::fs::getMainExecutable(
+        argv0, reinterpret_cast<void *>(&executableHash)));
+    if (!buffer) return "";
+
+    llvm::MD5 hash;
+    hash.update((*buffer)->getBuffer());
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> text;
+    llvm::MD5::stringifyResult(result, text);
+    return text.str().str();
+}
+
+// flags writing dependency files, dropped from the compile commands
+const char *const kDependencyFlags[] = {"-M",  "-MM", "-MD", "-MMD",
+                                        "-MG", "-MP", "-MV"};
+// dependency flags taking a file or target, as next or joined argument
+const char *const kDependencyFlagsWithArgument[] = {"-MF", "-MT", "-MQ"};
+
+/**
+ * Checks if an argument names the output file, as -o <path> or -o<path>.
+ * Driver flags starting with -obj, e.g. -objcmt-migrate-literals, are
+ * not outputs.
+ *
+ * @param argument
+ *
+ * @return true if the argument is an output flag
+ */
+bool isOutputFlag(const llvm::StringRef argument) {
+    return argument.startswith("-o") && !argument.startswith("-obj");
+}
+
+/**
+ * Prepares a compile command for analysis. Outputs, dependency files and
+ * compile only flags are dropped, so that the driver creates a single
+ * syntax only job writing no build artifacts.
+ *
+ * @param command compile command from the database
+ *
+ * @return command line
+ */
+std::vector<std::string> analysisCommandLine(const CompileCommand &command) {
+    std::vector<std::string> commandLine;
+    for (size_t i = 0; i < command.CommandLine.size(); ++i) {
+        const llvm::StringRef argument = command.CommandLine[i];
+        if (argument == "-o") {
+            ++i;  // skip output file
+            continue;
+        }
+        if (isOutputFlag(argument) || argument == "-c" ||
+            // dependency flags passed through to the preprocessor
+            argument.startswith("-Wp,-M")) {
+            continue;
+        }
+        if (std::find(std::begin(kDependencyFlags),
+                      std::end(kDependencyFlags),
+                      argument) != std::end(kDependencyFlags)) {
+            continue;
+        }
+        auto flagWithArgument = std::find_if(
+            std::begin(kDependencyFlagsWithArgument),
+            std::end(kDependencyFlagsWithArgument),
+            [&](const char *flag) { return argument.startswith(flag); });
+        if (flagWithArgument != std::end(kDependencyFlagsWithArgument)) {
+            if (argument == *flagWithArgument) ++i;  // skip file or target
+            continue;
+        }
+        commandLine.push_back(argument.str());
+    }
+    commandLine.push_back("-fsyntax-only");
+    // relative paths are resolved without changing the process wide
+    // working directory, which is shared by all worker threads
+    commandLine.push_back("-working-directory=" + command.Directory);
+    return commandLine;
+}
+
+/**
+ * Runs an action for the translation unit of a compile command.
+ *
+ * @param command compile command of the translation unit
+ * @param actionFactory
+ * @param diagConsumer
+ *
+ * @return success
+ */
+bool run(const CompileCommand &command, FrontendActionFactory &actionFactory,
+         DiagnosticConsumer &diagConsumer) {
+    FileSystemOptions fileSystemOpts;
+    fileSystemOpts.WorkingDir = command.Directory;
+    IntrusiveRefCntPtr<FileManager> files{new FileManager{fileSystemOpts}};
+
+    ToolInvocation invocation{analysisCommandLine(command), &actionFactory,
+                              files.get()};
+    invocation.setDiagnosticConsumer(&diagConsumer);
+    return invocation.run();
+}
+
+/**
+ * Analyses one translation unit. Diagnostics are buffered so that
+ * output of different translation units does not interleave.
+ *
+ * @param command compile command of the translation unit
+ * @param output buffered diagnostics
+ * @param warningCount number of emitted warnings
+ *
+ * @return success
+ */
+bool analyse(const CompileCommand &command, std::string &output,
+             unsigned &warningCount) {
+    llvm::raw_string_ostream outputStream{output};
+    IntrusiveRefCntPtr<DiagnosticOptions> diagOpts{new DiagnosticOptions};
+    TextDiagnosticPrinter diagPrinter{outputStream, &*diagOpts};
+
+    MPICheckActionFactory actionFactory;
+    const bool isSuccess = run(command, actionFactory, diagPrinter);
+
+    outputStream.flush();
+    warningCount = diagPrinter.getNumWarnings();
+    return isSuccess;
+}
+
+/**
+ * Computes the cache key of a translation unit from the tool hash,
+ * the analysis command line, the mode and the preprocessed content.
+ *
+ * @param command compile command of the translation unit
+ * @param key resulting key
+ * @param mainFilePath main file as seen by the analysis
+ *
+ * @return false if the translation unit could not be preprocessed
+ */
+bool cacheKey(const CompileCommand &command, std::string &key,
+              std::string &mainFilePath) {
+    llvm::MD5 hash;
+    hash.update(toolHash);
+    for (const std::string &argument : analysisCommandLine(command)) {
+        hash.update(argument);
+        hash.update(llvm::StringRef{"\0", 1});
+    }
+    hash.update(summaryDir.empty() ? "ast" : "summary");
+
+    IgnoringDiagConsumer diagConsumer;
+    PreprocessedHashFactory actionFactory{hash, mainFilePath};
+    if (!run(command, actionFactory, diagConsumer)) return false;
+
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> text;
+    llvm::MD5::stringifyResult(result, text);
+    key = text.str().str();
+    return true;
+}
+
+/**
+ * Writes a file, replacing existing content.
+ *
+ * @param path
+ * @param content
+ *
+ * @return success
+ */
+bool writeFile(const std::string &path, llvm::StringRef content) {
+    std::error_code errorCode;
+    llvm::raw_fd_ostream stream{path, errorCode, llvm::sys::fs::F_None};
+    if (errorCode) return false;
+    stream << content;
+    stream.close();
+    if (stream.has_error()) {
+        stream.clear_error();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Analyses one translation unit unless the cache holds a result for its
+ * key. On a hit the stored diagnostics are replayed and, in summary mode,
+ * the stored summary is restored.
+ *
+ * @param command compile command of the translation unit
+ * @param cache
+ * @param output buffered diagnostics
+ * @param warningCount number of emitted warnings
+ * @param isHit true if the result was replayed from cache
+ *
+ * @return success
+ */
+bool analyseCached(const CompileCommand &command,
+                   const mpi::AnalysisCache &cache, std::string &output,
+                   unsigned &warningCount, bool &isHit) {
+    isHit = false;
+    std::string key;
+    std::string mainFilePath;
+    if (!cacheKey(command, key, mainFilePath)) {
+        return analyse(command, output, warningCount);
+    }
+
+    llvm::SmallString<128> summaryPath{summaryDir};
+    llvm::sys::path::append(summaryPath, mpi::summaryFileName(mainFilePath));
+
+    mpi::CacheEntry entry;
+    if (cache.lookup(key, entry) &&
+        (entry.summaryName_.empty() ||
+         writeFile(summaryPath.str().str(), entry.summary_))) {
+        output = std::move(entry.output_);
+        warningCount = entry.warningCount_;
+        isHit = true;
+        return true;
+    }
+
+    // failed analyses are not cached, they are retried on the next run
+    if (!analyse(command, output, warningCount)) return false;
+
+    entry.output_ = output;
+    entry.warningCount_ = warningCount;
+    entry.summaryName_.clear();
+    entry.summary_.clear();
+    if (!summaryDir.empty()) {
+        auto summary = llvm::MemoryBuffer::getFile(summaryPath);
+        if (!summary) return true;
+        entry.summaryName_ = llvm::sys::path::filename(summaryPath).str();
+        entry.summary_ = (*summary)->getBuffer().str();
+    }
+    cache.store(key, entry);
+    return true;
+}
+
+/**
+ * Matches point to point calls across all summaries of the summary
+ * directory and prints the resulting diagnostics.
+ *
+ * @param warningCount incremented by the number of diagnostics
+ *
+ * @return success
+ */
+bool mergeSummaries(unsigned &warningCount) {
+    std::vector<mpi::MPISummary> summaries;
+    std::error_code errorCode;
+    for (llvm::sys::fs::directory_iterator it{summaryDir, errorCode}, end;
+         it != end && !errorCode; it.increment(errorCode)) {
+        if (llvm::sys::path::extension(it->path()) != ".mpisummary") continue;
+
+        summaries.emplace_back();
+        if (!summaries.back().read(it->path())) {
+            llvm::errs() << "mpi-check: invalid summary " << it->path()
+                         << "\n";
+            summaries.pop_back();
+        }
+    }
+    if (errorCode) {
+        llvm::errs() << "mpi-check: " << summaryDir << ": "
+                     << errorCode.message() << "\n";
+        return false;
+    }
+
+    for (const mpi::SummaryDiagnostic &diagnostic :
+         mpi::mergeSummaries(summaries)) {
+        llvm::errs() << diagnostic.location_ << ": warning: "
+                     << diagnostic.message_ << "\n";
+        ++warningCount;
+    }
+    llvm::errs() << summaries.size() << " summaries merged\n";
+    return true;
+}
+
+}  // end of anonymous namespace
+
+int main(int argc, const char **argv) {
+    llvm::cl::ParseCommandLineOptions(
+        argc, argv, "Runs the ast based MPI checks in parallel.\n");
+
+    for (const std::string &dir : {summaryDir.getValue(),
+                                   statsDir.getValue()}) {
+        if (dir.empty() || isMergeOnly) continue;
+        if (std::error_code errorCode =
+                llvm::sys::fs::create_directories(dir)) {
+            llvm::errs() << "mpi-check: " << dir << ": "
+                         << errorCode.message() << "\n";
+            return 1;
+        }
+    }
+    mpi::AnalysisCache cache{cacheDir};
+    if (!cacheDir.empty() && !isMergeOnly) {
+        if (!cache.create()) return 1;
+        toolHash = executableHash(argv[0]);
+    }
+    if (isMergeOnly) {
+        unsigned warningCount{0};
+        if (summaryDir.empty()) {
+            llvm::errs() << "mpi-check: --merge-only requires --summary-dir\n";
+            return 1;
+        }
+        return mergeSummaries(warningCount) ? 0 : 1;
+    }
+
+    std::string errorMessage;
+    std::unique_ptr<CompilationDatabase> database{
+        CompilationDatabase::autoDetectFromDirectory(buildPath,
+                                                     errorMessage)};
+    if (!database) {
+        llvm::errs() << "mpi-check: " << errorMessage << "\n";
+        return 1;
+    }
+
+    // one job per compile command
+    std::vector<CompileCommand> commands;
+    const std::vector<std::string> files{
+        sourcePaths.empty() ? database->getAllFiles()
+                            : std::vector<std::string>{sourcePaths.begin(),
+                                                       sourcePaths.end()}};
+    for (const std::string &file : files) {
+        std::vector<CompileCommand> fileCommands =
+            database->getCompileCommands(file);
+        if (fileCommands.empty()) {
+            llvm::errs() << "mpi-check: no compile command for " << file
+                         << "\n";
+        }
+        commands.insert(commands.end(), fileCommands.begin(),
+                        fileCommands.end());
+    }
+
+    unsigned threadCount{jobCount ? jobCount
+                                  : std::thread::hardware_concurrency()};
+    if (!threadCount) threadCount = 1;
+
+    std::atomic<size_t> nextCommand{0};
+    std::atomic<unsigned> warningCount{0};
+    std::atomic<unsigned> failureCount{0};
+    std::atomic<unsigned> hitCount{0};
+    std::mutex outputMutex;
+
+    auto worker = [&] {
+        for (size_t idx = nextCommand++; idx < commands.size();
+             idx = nextCommand++) {
+            std::string output;
+            unsigned warnings{0};
+            bool isHit{false};
+            const bool isSuccess =
+                cacheDir.empty()
+                    ? analyse(commands[idx], output, warnings)
+                    : analyseCached(commands[idx], cache, output, warnings,
+                                    isHit);
+            if (!isSuccess) ++failureCount;
+            if (isHit) ++hitCount;
+            warningCount += warnings;
+
+            std::lock_guard<std::mutex> lock{outputMutex};
+            llvm::errs() << output;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i) threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads) thread.join();
+
+    // point to point matching across translation units
+    unsigned mergeWarningCount{0};
+    if (!summaryDir.empty() && !mergeSummaries(mergeWarningCount)) {
+        ++failureCount;
+    }
+    warningCount += mergeWarningCount;
+
+    llvm::errs() << commands.size() << " translation units analysed, "
+                 << warningCount << " warnings";
+    if (!cacheDir.empty()) llvm::errs() << ", " << hitCount << " cached";
+    if (failureCount) llvm::errs() << ", " << failureCount << " failed";
+    llvm::errs() << "\n";
+
+    return failureCount ? 1 : 0;
+}